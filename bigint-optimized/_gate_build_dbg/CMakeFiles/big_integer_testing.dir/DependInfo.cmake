@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/bigint-optimized/big_integer.cpp" "CMakeFiles/big_integer_testing.dir/big_integer.cpp.o" "gcc" "CMakeFiles/big_integer_testing.dir/big_integer.cpp.o.d"
+  "/root/repo/bigint-optimized/big_integer_gmp.cpp" "CMakeFiles/big_integer_testing.dir/big_integer_gmp.cpp.o" "gcc" "CMakeFiles/big_integer_testing.dir/big_integer_gmp.cpp.o.d"
+  "/root/repo/bigint-optimized/big_integer_testing.cpp" "CMakeFiles/big_integer_testing.dir/big_integer_testing.cpp.o" "gcc" "CMakeFiles/big_integer_testing.dir/big_integer_testing.cpp.o.d"
+  "/root/repo/bigint-optimized/gtest/gtest-all.cc" "CMakeFiles/big_integer_testing.dir/gtest/gtest-all.cc.o" "gcc" "CMakeFiles/big_integer_testing.dir/gtest/gtest-all.cc.o.d"
+  "/root/repo/bigint-optimized/gtest/gtest_main.cc" "CMakeFiles/big_integer_testing.dir/gtest/gtest_main.cc.o" "gcc" "CMakeFiles/big_integer_testing.dir/gtest/gtest_main.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
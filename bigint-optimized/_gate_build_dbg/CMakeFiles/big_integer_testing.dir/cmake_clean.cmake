@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/big_integer_testing.dir/big_integer.cpp.o"
+  "CMakeFiles/big_integer_testing.dir/big_integer.cpp.o.d"
+  "CMakeFiles/big_integer_testing.dir/big_integer_gmp.cpp.o"
+  "CMakeFiles/big_integer_testing.dir/big_integer_gmp.cpp.o.d"
+  "CMakeFiles/big_integer_testing.dir/big_integer_testing.cpp.o"
+  "CMakeFiles/big_integer_testing.dir/big_integer_testing.cpp.o.d"
+  "CMakeFiles/big_integer_testing.dir/gtest/gtest-all.cc.o"
+  "CMakeFiles/big_integer_testing.dir/gtest/gtest-all.cc.o.d"
+  "CMakeFiles/big_integer_testing.dir/gtest/gtest_main.cc.o"
+  "CMakeFiles/big_integer_testing.dir/gtest/gtest_main.cc.o.d"
+  "big_integer_testing"
+  "big_integer_testing.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/big_integer_testing.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -22,6 +22,11 @@ big_integer::big_integer() {
 
 big_integer::big_integer(big_integer const &other) : size(other.size), sign(other.sign), bits(other.bits) {}
 
+// the moved-from number is left as zero, no reference count is touched
+big_integer::big_integer(big_integer &&other) noexcept : big_integer() {
+    swap(*this, other);
+}
+
 big_integer::big_integer(int a) {
     bits.push_back(std::abs(static_cast<int64_t>(a)));
     sign = a < 0;
@@ -45,6 +50,13 @@ big_integer &big_integer::operator=(big_integer const &other) {
     return *this;
 }
 
+// the moved-from number is left as zero, the old value goes with the temporary
+big_integer &big_integer::operator=(big_integer &&other) noexcept {
+    big_integer moved(std::move(other));
+    swap(*this, moved);
+    return *this;
+}
+
 big_integer::~big_integer() = default;
 
 // =====================================================================
@@ -193,18 +205,126 @@ big_integer increase(big_integer const &first, uint32_t second) {
     return multiply;
 }
 
+// operands shorter than this (in limbs) are multiplied by the schoolbook loop
+static const size_t KARATSUBA_THRESHOLD = 32;
+
+// first[0, length) += second[0, second_length), second_length <= length, returns carry
+static uint32_t add_limbs(uint32_t *first, size_t length, uint32_t const *second, size_t second_length) {
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < second_length; i++) {
+        uint64_t result = static_cast<uint64_t>(first[i]) + second[i] + carry;
+        first[i] = remainder(result);
+        carry = result >> 32u;
+    }
+    for (; i < length && carry; i++) {
+        first[i]++;
+        carry = first[i] == 0;
+    }
+    return static_cast<uint32_t>(carry);
+}
+
+// first[0, length) -= second[0, second_length), second_length <= length, first must be not less than second
+static void sub_limbs(uint32_t *first, size_t length, uint32_t const *second, size_t second_length) {
+    uint32_t borrow = 0;
+    size_t i = 0;
+    for (; i < second_length; i++) {
+        uint64_t difference = BASE + first[i] - second[i] - borrow;
+        first[i] = remainder(difference);
+        borrow = 1 - static_cast<uint32_t>(difference >> 32u);
+    }
+    for (; i < length && borrow; i++) {
+        borrow = first[i] == 0;
+        first[i]--;
+    }
+}
+
+// answer[0, first_length + second_length) = first * second, answer must not overlap with operands
+static void mul_basecase(uint32_t *answer, uint32_t const *first, size_t first_length,
+                         uint32_t const *second, size_t second_length) {
+    std::fill(answer, answer + first_length + second_length, 0);
+    for (size_t i = 0; i < first_length; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < second_length; j++) {
+            uint64_t result = static_cast<uint64_t>(first[i]) * second[j] + carry + answer[i + j];
+            answer[i + j] = remainder(result);
+            carry = result >> 32u;
+        }
+        answer[i + second_length] = static_cast<uint32_t>(carry);
+    }
+}
+
+static void mul_limbs(uint32_t *answer, uint32_t const *first, size_t first_length,
+                      uint32_t const *second, size_t second_length);
+
+// second_length <= first_length < 2 * second_length
+// first = first_high * B^half + first_low, second = second_high * B^half + second_low
+// first * second = high * B^(2 * half) + (middle - high - low) * B^half + low,
+// where middle = (first_low + first_high) * (second_low + second_high)
+static void karatsuba(uint32_t *answer, uint32_t const *first, size_t first_length,
+                      uint32_t const *second, size_t second_length) {
+    size_t half = (first_length + 1) / 2;
+    size_t first_high = first_length - half, second_high = second_length - half;
+    size_t length = first_length + second_length;
+
+    mul_limbs(answer, first, half, second, half);
+    std::fill(answer + 2 * half, answer + length, 0);
+    mul_limbs(answer + 2 * half, first + half, first_high, second + half, second_high);
+
+    std::vector<uint32_t> first_sum(first, first + half), second_sum(second, second + half);
+    first_sum.push_back(add_limbs(first_sum.data(), half, first + half, first_high));
+    second_sum.push_back(add_limbs(second_sum.data(), half, second + half, second_high));
+    std::vector<uint32_t> middle(2 * half + 2);
+    mul_limbs(middle.data(), first_sum.data(), half + 1, second_sum.data(), half + 1);
+    sub_limbs(middle.data(), middle.size(), answer, 2 * half);
+    sub_limbs(middle.data(), middle.size(), answer + 2 * half, first_high + second_high);
+
+    size_t middle_length = middle.size();
+    while (middle_length > 0 && middle[middle_length - 1] == 0) {
+        middle_length--;
+    }
+    add_limbs(answer + half, length - half, middle.data(), middle_length);
+}
+
+// answer[0, first_length + second_length) = first * second, answer must not overlap with operands
+static void mul_limbs(uint32_t *answer, uint32_t const *first, size_t first_length,
+                      uint32_t const *second, size_t second_length) {
+    if (first_length < second_length) {
+        std::swap(first, second);
+        std::swap(first_length, second_length);
+    }
+    if (second_length < KARATSUBA_THRESHOLD) {
+        mul_basecase(answer, first, first_length, second, second_length);
+    } else if (first_length >= 2 * second_length) {
+        // unbalanced operands: multiply second by chunks of first of the same length
+        std::fill(answer, answer + first_length + second_length, 0);
+        std::vector<uint32_t> product(2 * second_length);
+        for (size_t i = 0; i < first_length; i += second_length) {
+            size_t chunk = std::min(second_length, first_length - i);
+            mul_limbs(product.data(), first + i, chunk, second, second_length);
+            add_limbs(answer + i, first_length + second_length - i, product.data(), chunk + second_length);
+        }
+    } else {
+        karatsuba(answer, first, first_length, second, second_length);
+    }
+}
+
 big_integer operator*(big_integer const &a, big_integer const &b) {
     big_integer answer;
-    answer.allocate(a.size + b.size + 1);
-    uint64_t carry;
+    if (!a.size || !b.size) {
+        return answer;
+    }
+    std::vector<uint32_t> first(a.size), second(b.size), product(a.size + b.size);
     for (size_t i = 0; i < a.size; i++) {
-        carry = 0;
-        for (size_t j = 0; j < b.size || carry; j++) {
-            uint64_t result =
-                    static_cast<uint64_t>(a[i]) * (b.size > j ? b[j] : 0) + carry + answer[i + j];
-            answer[i + j] = (remainder(result));
-            carry = result >> 32u;
-        }
+        first[i] = a[i];
+    }
+    for (size_t i = 0; i < b.size; i++) {
+        second[i] = b[i];
+    }
+    mul_limbs(product.data(), first.data(), a.size, second.data(), b.size);
+    answer.allocate(product.size());
+    for (size_t i = 0; i < product.size(); i++) {
+        answer[i] = product[i];
     }
     answer.sign = a.sign ^ b.sign;
     answer.normalise();
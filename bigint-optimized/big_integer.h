@@ -16,6 +16,8 @@ struct big_integer {
 
     big_integer(big_integer const &other);
 
+    big_integer(big_integer &&other) noexcept;
+
     big_integer(int a);
 
     explicit big_integer(std::string const &str);
@@ -24,6 +26,8 @@ struct big_integer {
 
     big_integer &operator=(big_integer const &other);
 
+    big_integer &operator=(big_integer &&other) noexcept;
+
     big_integer &operator+=(big_integer const &rhs);
 
     big_integer &operator-=(big_integer const &rhs);
@@ -67,6 +67,26 @@ TEST(correctness, self_assignment) {
     EXPECT_TRUE(a == 5);
 }
 
+TEST(correctness, move_semantics) {
+    big_integer a("-123456789012345678901234567890123456789");
+    big_integer small = 5;
+    big_integer b = a;
+
+    big_integer moved(std::move(b));
+    EXPECT_TRUE(moved == a);
+    EXPECT_TRUE(b == 0);
+    b = std::move(small);
+    EXPECT_TRUE(b == 5);
+    EXPECT_TRUE(small == 0);
+    b = std::move(moved);
+    EXPECT_TRUE(b == a);
+    EXPECT_TRUE(moved == 0);
+    b = std::move(b);
+    EXPECT_TRUE(b == a);
+    b = a + a;
+    EXPECT_TRUE(b == a * 2);
+}
+
 TEST(correctness, assignment_return_value) {
     big_integer a = 4;
     big_integer b = 7;
@@ -744,6 +764,21 @@ TEST(correctness_random, mul) {
     }
 }
 
+TEST(correctness_random, mul_long_operands) {
+    std::default_random_engine rng(42);
+    size_t const sizes[][2] = {{max_size * 8, max_size * 8},
+                               {max_size * 16, max_size * 3},
+                               {max_size * 5, max_size * 4}};
+    for (auto const &size : sizes) {
+        big_integer_gmp a, b;
+        a.random(size[0], rng);
+        b.random(size[1], rng);
+        big_integer_gmp c = a * b;
+        big_integer R = big_integer(to_string(a)) * big_integer(to_string(b));
+        EXPECT_EQ(to_string(c), to_string(R));
+    }
+}
+
 TEST(correctness_random, div) {
     std::default_random_engine rng(322);
     for (size_t itn = 0; itn != number_of_iterations; ++itn) {
@@ -3,28 +3,74 @@
 #include <cstring>
 #include <stdexcept>
 #include <algorithm>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+// bitwise operations on long operands use AVX2 or AVX-512 when the processor supports them
+#define BIG_INTEGER_SIMD
+#endif
+
+#if defined(BIG_INTEGER_LIMB_BITS) && BIG_INTEGER_LIMB_BITS == 64 && defined(__x86_64__)
+#include <x86intrin.h>
+// carry chains of 64-bit limbs are built from the adc and sbb instructions
+#define BIG_INTEGER_ADDCARRY
+#endif
 
 
 // ======================================================== initialisation ======================================================
 
-const uint32_t SMALL_BITS = 0xFFFFFFFF;
+static const unsigned LIMB_BITS = std::numeric_limits<limb_t>::digits;
 
-uint32_t remainder(uint64_t result) {
-    return result & SMALL_BITS;
+const limb_t SMALL_BITS = std::numeric_limits<limb_t>::max();
+
+limb_t remainder(double_limb_t result) {
+    return static_cast<limb_t>(result & SMALL_BITS);
 }
 
+// limbs taken by a native 64-bit magnitude
+static const size_t NATIVE_LIMBS = 64 / LIMB_BITS;
 
-static big_integer const &ten() {
-    static const big_integer RESULT(10);
-    return RESULT;
+// limbs[0, NATIVE_LIMBS) = magnitude, returns the length without leading zeros
+static size_t split_native(limb_t *limbs, uint64_t magnitude) {
+    size_t length = 0;
+    for (double_limb_t rest = magnitude; rest; rest >>= LIMB_BITS) {
+        limbs[length++] = remainder(rest);
+    }
+    return length;
 }
 
-static const uint64_t BASE = (1ull << 32u);
+// bitwise operations on limbs and on vectors of limbs, first = first OP second
+struct and_operation {
+    template<typename T>
+    __attribute__((always_inline)) inline void operator()(T &first, T const &second) const {
+        first &= second;
+    }
+};
+
+struct or_operation {
+    template<typename T>
+    __attribute__((always_inline)) inline void operator()(T &first, T const &second) const {
+        first |= second;
+    }
+};
+
+struct xor_operation {
+    template<typename T>
+    __attribute__((always_inline)) inline void operator()(T &first, T const &second) const {
+        first ^= second;
+    }
+};
 
 big_integer::big_integer() : bits(), sign(false) {}
 
 big_integer::big_integer(big_integer const &other) = default;
 
+// the moved-from number is left as zero
+big_integer::big_integer(big_integer &&other) noexcept : bits(std::move(other.bits)), sign(other.sign) {
+    other.bits.clear();
+    other.sign = false;
+}
+
 big_integer::big_integer(int a) : bits(1, std::abs(static_cast<int64_t>(a))) {
     sign = a < 0;
     normalise();
@@ -36,16 +82,31 @@ big_integer::big_integer(std::string const &str) : big_integer() {
         if (!std::isdigit(str[i])) {
             throw std::runtime_error("incorrect number");
         }
-        *this *= ten();
-        *this += (str[i] - '0');
     }
+    from_decimal(*this, str.data() + minus, str.size() - minus);
     sign = minus;
     this->normalise();
 }
 
+// *this = (negative ? -magnitude : magnitude), the existing buffer is reused
+void big_integer::assign_native(uint64_t magnitude, bool negative) {
+    limb_t limbs[NATIVE_LIMBS];
+    bits.assign(limbs, limbs + split_native(limbs, magnitude));
+    sign = negative;
+    normalise();
+}
+
+// the limbs are copied into the existing buffer when it is large enough
 big_integer &big_integer::operator=(big_integer const &other) {
-    big_integer copy(other);
-    swap(*this, copy);
+    bits = other.bits;
+    sign = other.sign;
+    return *this;
+}
+
+// the moved-from number is left as zero, the old value goes with the temporary
+big_integer &big_integer::operator=(big_integer &&other) noexcept {
+    big_integer moved(std::move(other));
+    swap(*this, moved);
     return *this;
 }
 
@@ -56,17 +117,23 @@ big_integer::~big_integer() = default;
 // ========================== Operator: operation= =================================
 
 big_integer &big_integer::operator+=(big_integer const &rhs) {
-    *this = *this + rhs;
+    add_multiple(*this, rhs, 1, false);
     return *this;
 }
 
 big_integer &big_integer::operator-=(big_integer const &rhs) {
-    *this = *this - rhs;
+    add_multiple(*this, rhs, 1, true);
     return *this;
 }
 
 big_integer &big_integer::operator*=(big_integer const &rhs) {
-    *this = *this * rhs;
+    if (rhs.size() == 1) {
+        sign ^= rhs.sign;
+        mul_limb(rhs[0]);
+    } else {
+        big_integer product = *this * rhs;
+        swap(*this, product);
+    }
     return *this;
 }
 
@@ -81,27 +148,37 @@ big_integer &big_integer::operator%=(big_integer const &rhs) {
 }
 
 big_integer &big_integer::operator&=(big_integer const &rhs) {
-    *this = *this & rhs;
+    bit_operation(*this, *this, rhs, and_operation());
     return *this;
 }
 
 big_integer &big_integer::operator|=(big_integer const &rhs) {
-    *this = *this | rhs;
+    bit_operation(*this, *this, rhs, or_operation());
     return *this;
 }
 
 big_integer &big_integer::operator^=(big_integer const &rhs) {
-    *this = *this ^ rhs;
+    bit_operation(*this, *this, rhs, xor_operation());
     return *this;
 }
 
 big_integer &big_integer::operator<<=(int rhs) {
-    *this = *this << rhs;
+    if (rhs < 0) {
+        return *this >>= -rhs;
+    }
+    shift_left(static_cast<size_t>(rhs));
     return *this;
 }
 
 big_integer &big_integer::operator>>=(int rhs) {
-    *this = *this >> rhs;
+    if (rhs < 0) {
+        return *this <<= -rhs;
+    }
+    bool negative = sign;
+    // the shift rounds towards minus infinity, so a negative value loses one more if any bit is dropped
+    if (shift_right(static_cast<size_t>(rhs)) && negative) {
+        *this -= 1;
+    }
     return *this;
 }
 
@@ -113,17 +190,28 @@ big_integer big_integer::operator+() const {
     return *this;
 }
 
-big_integer big_integer::operator-() const {
-    if (size() == 0) {
-        return *this;
-    }
+big_integer big_integer::operator-() const & {
     big_integer copy = *this;
-    copy.sign = !copy.sign;
-    return copy;
+    return -std::move(copy);
 }
 
-big_integer big_integer::operator~() const {
-    return -(*this + 1);
+big_integer big_integer::operator-() && {
+    sign = !sign;
+    normalise();
+    return std::move(*this);
+}
+
+// ~x = -x - 1, in sign and magnitude this is a carry chain rather than a limb by limb operation
+big_integer big_integer::operator~() const & {
+    big_integer copy = *this;
+    return ~std::move(copy);
+}
+
+big_integer big_integer::operator~() && {
+    *this += 1;
+    sign = !sign;
+    normalise();
+    return std::move(*this);
 }
 
 big_integer &big_integer::operator++() {
@@ -150,29 +238,96 @@ big_integer big_integer::operator--(int) {
 // ================================================================================
 // ======================================= add =========================================
 
+// first[0, length) += second[0, second_length), second_length <= length, returns carry
+static limb_t add_limbs(limb_t *first, size_t length, limb_t const *second, size_t second_length) {
+    limb_t carry = 0;
+    size_t i = 0;
+    for (; i < second_length; i++) {
+#ifdef BIG_INTEGER_ADDCARRY
+        unsigned long long sum;
+        carry = _addcarry_u64(static_cast<unsigned char>(carry), first[i], second[i], &sum);
+        first[i] = sum;
+#else
+        double_limb_t result = static_cast<double_limb_t>(first[i]) + second[i] + carry;
+        first[i] = remainder(result);
+        carry = static_cast<limb_t>(result >> LIMB_BITS);
+#endif
+    }
+    for (; i < length && carry; i++) {
+        first[i]++;
+        carry = first[i] == 0;
+    }
+    return carry;
+}
+
+// first[0, length) -= second[0, second_length), second_length <= length, returns borrow
+static limb_t sub_limbs(limb_t *first, size_t length, limb_t const *second, size_t second_length) {
+    limb_t borrow = 0;
+    size_t i = 0;
+    for (; i < second_length; i++) {
+#ifdef BIG_INTEGER_ADDCARRY
+        unsigned long long difference;
+        borrow = _subborrow_u64(static_cast<unsigned char>(borrow), first[i], second[i], &difference);
+        first[i] = difference;
+#else
+        double_limb_t difference = static_cast<double_limb_t>(first[i]) - second[i] - borrow;
+        first[i] = remainder(difference);
+        borrow = (difference >> LIMB_BITS) != 0;
+#endif
+    }
+    for (; i < length && borrow; i++) {
+        borrow = first[i] == 0;
+        first[i]--;
+    }
+    return borrow;
+}
+
+// first[0, length) = second[0, length) - first[0, length), returns borrow
+static limb_t reverse_sub_limbs(limb_t *first, limb_t const *second, size_t length) {
+    limb_t borrow = 0;
+    for (size_t i = 0; i < length; i++) {
+#ifdef BIG_INTEGER_ADDCARRY
+        unsigned long long difference;
+        borrow = _subborrow_u64(static_cast<unsigned char>(borrow), second[i], first[i], &difference);
+        first[i] = difference;
+#else
+        double_limb_t difference = static_cast<double_limb_t>(second[i]) - first[i] - borrow;
+        first[i] = remainder(difference);
+        borrow = (difference >> LIMB_BITS) != 0;
+#endif
+    }
+    return borrow;
+}
+
+// compares first[0, first_length) and second[0, second_length) without leading zeros
+static int compare_limbs(limb_t const *first, size_t first_length, limb_t const *second, size_t second_length) {
+    if (first_length != second_length) {
+        return first_length < second_length ? -1 : 1;
+    }
+    for (size_t i = first_length; i > 0; i--) {
+        if (first[i - 1] != second[i - 1]) {
+            return first[i - 1] < second[i - 1] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
 big_integer operator+(big_integer const &a, big_integer const &b) {
-    bool minus = a.sign ^b.sign;
-    int first = 1, second = 1;
-    bool more = false;
-    if (minus) {
-        more = abs(a) >= abs(b);
-        first = more ? 1 : -1;
-        second = more ? -1 : 1;
-    }
-    int carry = 0;
     big_integer answer;
-    size_t firstSize = a.size(), secondSize = b.size();
-    for (size_t i = 0; i < std::max(firstSize, secondSize) || carry == 1; i++) {
-        int64_t one = a.return_value(i);
-        int64_t two = b.return_value(i);
-        uint64_t result = one * first + two * second + BASE + carry;
-        answer.push_back(remainder(result));
-        carry = static_cast<int>(result >> 32u) - 1;
-    }
-    if (minus) {
-        answer.sign = more? a.sign :b.sign;
-    } else {
+    if (a.sign == b.sign) {
+        big_integer const &longer = a.size() < b.size() ? b : a, &shorter = a.size() < b.size() ? a : b;
+        answer.bits.reserve(longer.size() + 1);
+        answer.bits = longer.bits;
+        answer.push_back(0);
+        add_limbs(answer.bits.data(), answer.size(), shorter.bits.data(), shorter.size());
         answer.sign = a.sign;
+    } else {
+        // subtract the smaller magnitude from the larger one, the result takes the sign of the larger
+        bool less = compare_limbs(a.bits.data(), a.size(), b.bits.data(), b.size()) < 0;
+        big_integer const &larger = less ? b : a, &smaller = less ? a : b;
+        answer.bits = larger.bits;
+        sub_limbs(answer.bits.data(), answer.size(), smaller.bits.data(), smaller.size());
+        answer.sign = larger.sign;
     }
     answer.normalise();
     return answer;
@@ -181,246 +336,2344 @@ big_integer operator+(big_integer const &a, big_integer const &b) {
 big_integer operator-(big_integer const &a, big_integer const &b) {
     return a + (-b);
 }
+
+// an expiring operand is reused as the result, so a + b + c allocates only once
+big_integer operator+(big_integer &&a, big_integer const &b) {
+    a += b;
+    return std::move(a);
+}
+
+big_integer operator+(big_integer const &a, big_integer &&b) {
+    b += a;
+    return std::move(b);
+}
+
+big_integer operator+(big_integer &&a, big_integer &&b) {
+    a += b;
+    return std::move(a);
+}
+
+big_integer operator-(big_integer &&a, big_integer const &b) {
+    a -= b;
+    return std::move(a);
+}
+
+big_integer operator-(big_integer const &a, big_integer &&b) {
+    b -= a;
+    return -std::move(b);
+}
+
+big_integer operator-(big_integer &&a, big_integer &&b) {
+    a -= b;
+    return std::move(a);
+}
+
+// *this += (negative ? -magnitude : magnitude) in place
+void big_integer::add_native(uint64_t magnitude, bool negative) {
+    limb_t limbs[NATIVE_LIMBS];
+    size_t length = split_native(limbs, magnitude);
+    if (sign == negative) {
+        bits.resize(std::max(size(), length), 0);
+        if (add_limbs(bits.data(), size(), limbs, length)) {
+            push_back(1);
+        }
+    } else if (compare_limbs(bits.data(), size(), limbs, length) >= 0) {
+        sub_limbs(bits.data(), size(), limbs, length);
+    } else {
+        // the magnitude is the larger one, so *this has at most length limbs
+        bits.resize(length, 0);
+        reverse_sub_limbs(bits.data(), limbs, length);
+        sign = negative;
+    }
+    normalise();
+}
+
+// -1, 0 or 1 as *this is less than, equal to or greater than (negative ? -magnitude : magnitude)
+int big_integer::compare_native(uint64_t magnitude, bool negative) const {
+    limb_t limbs[NATIVE_LIMBS];
+    size_t length = split_native(limbs, magnitude);
+    if (sign != negative && (size() || length)) {
+        return sign ? -1 : 1;
+    }
+    int result = compare_limbs(bits.data(), size(), limbs, length);
+    return sign ? -result : result;
+}
 // ============================================================================================
 
 
 // ================================= multiply =================================================
 
-// only multiplies on second, but doesn't normalise. Ex.: 1 0 0 * 0 = 0 0 0
-big_integer increase(big_integer const &first, uint32_t second) {
-    uint32_t carry = 0;
-    big_integer multiply;
-    for (size_t i = 0; i < first.size() || carry; i++) {
-        uint64_t result = static_cast<uint64_t>(first[i]) * second + carry;
-        multiply.push_back(remainder(result));
-        carry = result >> 32u;
+// *this *= factor in place
+void big_integer::mul_limb(limb_t factor) {
+    limb_t carry = 0;
+    for (limb_t &limb : bits) {
+        double_limb_t result = static_cast<double_limb_t>(limb) * factor + carry;
+        limb = remainder(result);
+        carry = static_cast<limb_t>(result >> LIMB_BITS);
+    }
+    if (carry) {
+        push_back(carry);
     }
-    return multiply;
+    normalise();
 }
 
-big_integer operator*(big_integer const &a, big_integer const &b) {
-    big_integer answer;
-    answer.allocate(a.size() + b.size() + 1);
-    uint64_t carry;
-    for (size_t i = 0; i < a.size(); i++) {
-        carry = 0;
-        for (size_t j = 0; j < b.size() || carry; j++) {
-            uint64_t result =
-                    static_cast<uint64_t>(a[i]) * (b.return_value(j)) + carry + answer[i + j];
-            answer[i + j] = (remainder(result));
-            carry = result >> 32u;
-        }
+// first[0, length) += second[0, length) * factor, returns the limb to be added above
+static limb_t addmul_limbs(limb_t *first, limb_t const *second, size_t length, limb_t factor) {
+    double_limb_t carry = 0;
+    for (size_t i = 0; i < length; i++) {
+        double_limb_t product = static_cast<double_limb_t>(second[i]) * factor + first[i] + carry;
+        first[i] = remainder(product);
+        carry = product >> LIMB_BITS;
     }
-    answer.sign = a.sign ^ b.sign;
-    answer.normalise();
-    return answer;
+    return static_cast<limb_t>(carry);
 }
-// ==========================================================================================
 
-// =============================== Division starts here =====================================
-bool smaller(big_integer const &first, big_integer const &second, size_t index) {
-    if (first.size() > second.size() + index && first[second.size() + index]) {
-        return false;
+// first[0, length) -= second[0, length) * factor, returns the limb to be subtracted above
+static limb_t submul_limbs(limb_t *first, limb_t const *second, size_t length, limb_t factor) {
+    double_limb_t carry = 0;
+    for (size_t i = 0; i < length; i++) {
+        double_limb_t product = static_cast<double_limb_t>(second[i]) * factor + carry;
+        limb_t low = remainder(product);
+        carry = (product >> LIMB_BITS) + (first[i] < low);
+        first[i] -= low;
     }
-    for (size_t i = second.size(); i > 0; i--) {
-        size_t j = i + index;
-        if (first[j - 1] != second[i - 1]) {
-            return first[j - 1] < second[i - 1];
+    return static_cast<limb_t>(carry);
+}
+
+// operands shorter than this (in limbs) are multiplied by the schoolbook loop
+static const size_t KARATSUBA_THRESHOLD = 32;
+// the same for squares, which the schoolbook loop computes twice as fast
+static const size_t KARATSUBA_SQR_THRESHOLD = 64;
+// Toom-3 replaces Karatsuba from this length on, Toom-4 replaces Toom-3
+static const size_t TOOM3_THRESHOLD = 800;
+static const size_t TOOM4_THRESHOLD = 1400;
+// number theoretic transform replaces Toom-Cook from this length on,
+// while the product fits into the longest transform supported by all three primes
+static const size_t NTT_THRESHOLD = 2000;
+static const size_t NTT_MAX_LENGTH = 1u << 23u;
+
+// answer[0, first_length + second_length) = first * second, answer must not overlap with operands
+static void mul_basecase(limb_t *answer, limb_t const *first, size_t first_length,
+                         limb_t const *second, size_t second_length) {
+    std::fill(answer, answer + first_length + second_length, 0);
+    for (size_t i = 0; i < first_length; i++) {
+        double_limb_t carry = 0;
+        for (size_t j = 0; j < second_length; j++) {
+            double_limb_t result = static_cast<double_limb_t>(first[i]) * second[j] + carry + answer[i + j];
+            answer[i + j] = remainder(result);
+            carry = result >> LIMB_BITS;
         }
+        answer[i + second_length] = static_cast<limb_t>(carry);
     }
-    return false;
 }
 
-void decrease(big_integer &first, big_integer const &second, size_t index) {
-    int borrow = 0;
-    for (size_t i = 0; i < second.size() || borrow; i++) {
-        uint64_t difference = BASE + first[index + i] - (second[i])
-                                        + borrow;
-        first[index + i] = remainder(difference);
-        borrow = static_cast<int32_t>(difference >> 32u) - 1;
+// answer[0, 2 * length) = number * number, every cross product is computed once and doubled
+static void sqr_basecase(limb_t *answer, limb_t const *number, size_t length) {
+    std::fill(answer, answer + 2 * length, 0);
+    for (size_t i = 0; i < length; i++) {
+        double_limb_t carry = 0;
+        for (size_t j = i + 1; j < length; j++) {
+            double_limb_t result = static_cast<double_limb_t>(number[i]) * number[j] + carry + answer[i + j];
+            answer[i + j] = remainder(result);
+            carry = result >> LIMB_BITS;
+        }
+        answer[i + length] = static_cast<limb_t>(carry);
+    }
+    limb_t shifted_out = 0;
+    for (size_t i = 0; i < 2 * length; i++) {
+        limb_t limb = answer[i];
+        answer[i] = (limb << 1u) | shifted_out;
+        shifted_out = limb >> (LIMB_BITS - 1);
+    }
+    double_limb_t carry = 0;
+    for (size_t i = 0; i < length; i++) {
+        double_limb_t square = static_cast<double_limb_t>(number[i]) * number[i];
+        double_limb_t low = static_cast<double_limb_t>(answer[2 * i]) + remainder(square) + carry;
+        answer[2 * i] = remainder(low);
+        double_limb_t high = static_cast<double_limb_t>(answer[2 * i + 1]) + (square >> LIMB_BITS) + (low >> LIMB_BITS);
+        answer[2 * i + 1] = remainder(high);
+        carry = high >> LIMB_BITS;
     }
 }
 
-big_integer short_div(big_integer const &first, uint32_t second) {
-    uint64_t rest = 0;
-    big_integer quotient;
-    quotient.allocate(first.size());
-    for (size_t i = first.size(); i > 0; i--) {
-        uint64_t result = BASE * rest + first[i - 1];
-        quotient[i - 1] = result / second;
-        rest = result % second;
+static void mul_limbs(limb_t *answer, limb_t const *first, size_t first_length,
+                      limb_t const *second, size_t second_length);
+
+// second_length <= first_length < 2 * second_length
+// first = first_high * B^half + first_low, second = second_high * B^half + second_low
+// first * second = high * B^(2 * half) + (middle - high - low) * B^half + low,
+// where middle = (first_low + first_high) * (second_low + second_high)
+static void karatsuba(limb_t *answer, limb_t const *first, size_t first_length,
+                      limb_t const *second, size_t second_length) {
+    size_t half = (first_length + 1) / 2;
+    size_t first_high = first_length - half, second_high = second_length - half;
+    size_t length = first_length + second_length;
+
+    mul_limbs(answer, first, half, second, half);
+    std::fill(answer + 2 * half, answer + length, 0);
+    mul_limbs(answer + 2 * half, first + half, first_high, second + half, second_high);
+
+    // squaring passes the same pointers down, so the middle product stays a square
+    bool square = first == second && first_length == second_length;
+    std::vector<limb_t> first_sum(first, first + half), second_sum;
+    first_sum.push_back(add_limbs(first_sum.data(), half, first + half, first_high));
+    if (!square) {
+        second_sum.assign(second, second + half);
+        second_sum.push_back(add_limbs(second_sum.data(), half, second + half, second_high));
     }
-    quotient.normalise();
-    if (first.sign && rest) {
-        quotient++;
+    std::vector<limb_t> middle(2 * half + 2);
+    mul_limbs(middle.data(), first_sum.data(), half + 1, (square ? first_sum : second_sum).data(), half + 1);
+    sub_limbs(middle.data(), middle.size(), answer, 2 * half);
+    sub_limbs(middle.data(), middle.size(), answer + 2 * half, first_high + second_high);
+
+    size_t middle_length = middle.size();
+    while (middle_length > 0 && middle[middle_length - 1] == 0) {
+        middle_length--;
     }
-    return quotient;
+    add_limbs(answer + half, length - half, middle.data(), middle_length);
 }
 
-big_integer operator/(big_integer const &a, big_integer const &b) {
-    big_integer quotient;
-    size_t position = b.size();
-    if (position == 1) {
-        quotient = short_div(abs(a), b[0]);
-    } else {
-        uint32_t f = BASE / (1ull + b[position - 1]);
-        big_integer remainder = increase(a, f);
-        big_integer divisor = increase(b, f);
-        remainder.push_back(0);
-        size_t length = remainder.size();
-        position = divisor.size();
-        for (int32_t i = length - position - 1; i >= 0; i--) {
-            uint64_t r = BASE * (remainder[i + position]) +
-                                   remainder[i + position - 1];
-            uint64_t q = divisor[position - 1];
-            auto qt = static_cast<uint32_t>(std::min(r / q, BASE - 1));
-            big_integer result = increase(divisor, qt);
-            while (smaller(remainder, result, i)) {
-                qt--;
-                result -= divisor;
-            }
-            decrease(remainder, result, i);
-            quotient.push_back(qt);
+// inverse of an odd limb modulo 2^LIMB_BITS, the limb itself is correct in 3 bits
+// and every Newton step doubles the number of correct bits
+static limb_t limb_inverse(limb_t odd) {
+    limb_t inverse = odd;
+    for (unsigned i = 3; i < LIMB_BITS; i *= 2) {
+        inverse *= 2 - odd * inverse;
+    }
+    return inverse;
+}
+
+// value /= divisor, the division must be exact
+void divide_exact(big_integer &value, limb_t divisor) {
+    std::vector<limb_t> &limbs = value.bits;
+    limb_t shift = 0;
+    while (divisor % 2 == 0) {
+        divisor /= 2;
+        shift++;
+    }
+    if (shift) {
+        for (size_t i = 0; i < limbs.size(); i++) {
+            limb_t next = i + 1 < limbs.size() ? limbs[i + 1] : 0;
+            limbs[i] = (limbs[i] >> shift) | (next << (LIMB_BITS - shift));
         }
-        quotient.reverse();
     }
-    quotient.sign = a.sign ^ b.sign;
-    quotient.normalise();
-    return quotient;
+    limb_t inverse = limb_inverse(divisor);
+    limb_t carry = 0;
+    for (size_t i = 0; i < limbs.size(); i++) {
+        limb_t borrow = limbs[i] < carry;
+        limb_t quotient = (limbs[i] - carry) * inverse;
+        limbs[i] = quotient;
+        carry = static_cast<limb_t>((static_cast<double_limb_t>(quotient) * divisor) >> LIMB_BITS) + borrow;
+    }
+    value.normalise();
 }
 
-// ==========================================================================================
-big_integer operator%(big_integer const &a, big_integer const &b) {
-    return a - (a / b * b);
+// to += value * factor, or to -= value * factor if subtract
+void add_multiple(big_integer &to, big_integer const &value, limb_t factor, bool subtract) {
+    if (&to == &value) {
+        big_integer copy(value);
+        add_multiple(to, copy, factor, subtract);
+        return;
+    }
+    if (factor != 1) {
+        to.add_product(value.bits.data(), value.size(), &factor, 1, value.sign ^ subtract);
+        return;
+    }
+    if (value.bits.empty()) {
+        return;
+    }
+    bool term_sign = value.sign ^ subtract;
+    if (to.size() == 0 || to.sign == term_sign) {
+        to.bits.resize(std::max(to.size(), value.bits.size()) + 1, 0);
+        add_limbs(to.bits.data(), to.size(), value.bits.data(), value.bits.size());
+        to.sign = term_sign;
+    } else if (compare_limbs(to.bits.data(), to.size(), value.bits.data(), value.bits.size()) >= 0) {
+        sub_limbs(to.bits.data(), to.size(), value.bits.data(), value.bits.size());
+    } else {
+        to.bits.resize(value.bits.size(), 0);
+        reverse_sub_limbs(to.bits.data(), value.bits.data(), value.bits.size());
+        to.sign = term_sign;
+    }
+    to.normalise();
 }
 
-big_integer bit_operation(big_integer const &a, big_integer const &b, const big_integer::function &function) {
-    big_integer real_a = additional(a.size() < b.size() ? b : a);
-    big_integer real_b = additional(a.size() < b.size() ? a : b);
-    if (real_a.size() < real_b.size()) {
-        swap(real_a, real_b);
+// sum of coefficients[i] * values[i]
+static big_integer combination(std::vector<std::pair<int, big_integer const *>> const &terms) {
+    big_integer result;
+    for (auto const &term : terms) {
+        add_multiple(result, *term.second, static_cast<limb_t>(std::abs(term.first)), term.first < 0);
     }
-    big_integer answer;
-    for (size_t i = 0; i < real_b.size(); i++) {
-        answer.push_back(function(real_a[i], real_b[i]));
+    return result;
+}
+
+static big_integer exact_quotient(big_integer value, limb_t divisor) {
+    divide_exact(value, divisor);
+    return value;
+}
+
+// c(x) = c0 + c1 x + c2 x^2 + c3 x^3 + c4 x^4 from values at 0, 1, -1, 2, inf
+static std::vector<big_integer> interpolate3(std::vector<big_integer> const &values) {
+    big_integer const &v0 = values[0], &v1 = values[1], &vm1 = values[2], &v2 = values[3], &vinf = values[4];
+    // c1 + c3 and c0 + c2 + c4
+    big_integer odd = exact_quotient(combination({{1, &v1}, {-1, &vm1}}), 2);
+    big_integer even = exact_quotient(combination({{1, &v1}, {1, &vm1}}), 2);
+    big_integer c2 = combination({{1, &even}, {-1, &v0}, {-1, &vinf}});
+    // (v2 - c0 - 4 c2 - 16 c4) / 2 = c1 + 4 c3
+    big_integer odd2 = exact_quotient(combination({{1, &v2}, {-1, &v0}, {-4, &c2}, {-16, &vinf}}), 2);
+    big_integer c3 = exact_quotient(combination({{1, &odd2}, {-1, &odd}}), 3);
+    big_integer c1 = combination({{1, &odd}, {-1, &c3}});
+    return {v0, c1, c2, c3, vinf};
+}
+
+// c(x) = c0 + ... + c6 x^6 from values at 0, 1, -1, 2, -2, 3, inf
+static std::vector<big_integer> interpolate4(std::vector<big_integer> const &values) {
+    big_integer const &v0 = values[0], &v1 = values[1], &vm1 = values[2];
+    big_integer const &v2 = values[3], &vm2 = values[4], &v3 = values[5], &vinf = values[6];
+    // even part: c2 + c4 and 4 c2 + 16 c4
+    big_integer even1 = exact_quotient(combination({{1, &v1}, {1, &vm1}}), 2);
+    big_integer even2 = exact_quotient(combination({{1, &v2}, {1, &vm2}}), 2);
+    big_integer low = combination({{1, &even1}, {-1, &v0}, {-1, &vinf}});
+    big_integer high = combination({{1, &even2}, {-1, &v0}, {-64, &vinf}});
+    big_integer c4 = exact_quotient(combination({{1, &high}, {-4, &low}}), 12);
+    big_integer c2 = combination({{1, &low}, {-1, &c4}});
+    // odd part: c1 + c3 + c5, c1 + 4 c3 + 16 c5 and c1 + 9 c3 + 81 c5
+    big_integer odd1 = exact_quotient(combination({{1, &v1}, {-1, &vm1}}), 2);
+    big_integer odd2 = exact_quotient(combination({{1, &v2}, {-1, &vm2}}), 4);
+    big_integer odd3 = exact_quotient(combination({{1, &v3}, {-1, &v0}, {-9, &c2}, {-81, &c4}, {-729, &vinf}}), 3);
+    // c3 + 5 c5 and c3 + 13 c5
+    big_integer first_difference = exact_quotient(combination({{1, &odd2}, {-1, &odd1}}), 3);
+    big_integer second_difference = exact_quotient(combination({{1, &odd3}, {-1, &odd2}}), 5);
+    big_integer c5 = exact_quotient(combination({{1, &second_difference}, {-1, &first_difference}}), 8);
+    big_integer c3 = combination({{1, &first_difference}, {-5, &c5}});
+    big_integer c1 = combination({{1, &odd1}, {-1, &c3}, {-1, &c5}});
+    return {v0, c1, c2, c3, c4, c5, vinf};
+}
+
+// sum of even and sum of odd terms of the polynomial with coefficients pieces at point,
+// so that its values at point and -point are even + odd and even - odd
+static std::pair<big_integer, big_integer> evaluate(std::vector<big_integer> const &pieces, limb_t point) {
+    big_integer even, odd;
+    limb_t power = 1;
+    for (size_t i = 0; i < pieces.size(); i++) {
+        add_multiple(i % 2 ? odd : even, pieces[i], power, false);
+        power *= point;
     }
-    uint32_t help = real_b.sign ? UINT32_MAX : 0;
-    for (size_t i = real_b.size(); i < real_a.size(); i++) {
-        answer.push_back(function(real_a[i], help));
+    return {even, odd};
+}
+
+// splits both operands into parts pieces of equal length, multiplies polynomials
+// with pieces as coefficients in 2 * parts - 1 points and interpolates the product
+void toom_cook(limb_t *answer, limb_t const *first, size_t first_length,
+               limb_t const *second, size_t second_length, size_t parts) {
+    size_t piece = (first_length + parts - 1) / parts;
+    auto split = [piece, parts](limb_t const *number, size_t length) {
+        std::vector<big_integer> pieces(parts);
+        for (size_t i = 0; i < parts && i * piece < length; i++) {
+            pieces[i].bits.assign(number + i * piece, number + std::min(length, (i + 1) * piece));
+            pieces[i].normalise();
+        }
+        return pieces;
+    };
+    // squares evaluate a single polynomial, and operator* squares the values
+    bool square = first == second && first_length == second_length;
+    std::vector<big_integer> first_pieces = split(first, first_length);
+    std::vector<big_integer> second_pieces = square ? first_pieces : split(second, second_length);
+
+    std::vector<big_integer> values;
+    values.push_back(first_pieces.front() * second_pieces.front());
+    // Toom-3 uses points 0, 1, -1, 2, inf and Toom-4 uses 0, 1, -1, 2, -2, 3, inf
+    for (limb_t point = 1; point < parts; point++) {
+        std::pair<big_integer, big_integer> first_value = evaluate(first_pieces, point);
+        std::pair<big_integer, big_integer> second_value = square ? first_value : evaluate(second_pieces, point);
+        big_integer const &first_even = first_value.first, &first_odd = first_value.second;
+        big_integer const &second_even = second_value.first, &second_odd = second_value.second;
+        values.push_back(combination({{1, &first_even}, {1, &first_odd}}) *
+                         combination({{1, &second_even}, {1, &second_odd}}));
+        if (point + 1 < parts) {
+            values.push_back(combination({{1, &first_even}, {-1, &first_odd}}) *
+                             combination({{1, &second_even}, {-1, &second_odd}}));
+        }
+    }
+    values.push_back(first_pieces.back() * second_pieces.back());
+
+    std::vector<big_integer> coefficients = parts == 3 ? interpolate3(values) : interpolate4(values);
+    size_t length = first_length + second_length;
+    std::fill(answer, answer + length, 0);
+    for (size_t i = 0; i < coefficients.size(); i++) {
+        std::vector<limb_t> const &limbs = coefficients[i].bits;
+        if (!limbs.empty()) {
+            add_limbs(answer + i * piece, length - i * piece, limbs.data(), limbs.size());
+        }
     }
-    answer.sign = function(a.sign, b.sign);
-    answer.normalise();
-    return additional(answer);
 }
 
-big_integer operator&(big_integer const &a, big_integer const &b) {
-    return bit_operation(a, b, [](uint32_t first, uint32_t second) { return first & second; });
+__extension__ typedef unsigned __int128 uint128_t;
+
+template<uint32_t MOD>
+static uint32_t power_mod(uint32_t base, uint32_t exponent) {
+    uint64_t result = 1, power = base;
+    for (; exponent; exponent >>= 1u) {
+        if (exponent & 1u) {
+            result = result * power % MOD;
+        }
+        power = power * power % MOD;
+    }
+    return static_cast<uint32_t>(result);
 }
 
-big_integer operator|(big_integer const &a, big_integer const &b) {
-    return bit_operation(a, b, [](uint32_t first, uint32_t second) { return first | second; });
+// in-place transform of values modulo MOD, values.size() is a power of two dividing MOD - 1
+template<uint32_t MOD, uint32_t ROOT>
+static void ntt(std::vector<uint32_t> &values, bool inverse) {
+    size_t length = values.size();
+    for (size_t i = 1, j = 0; i < length; i++) {
+        size_t bit = length >> 1u;
+        for (; j & bit; bit >>= 1u) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(values[i], values[j]);
+        }
+    }
+    std::vector<uint32_t> roots(length / 2);
+    for (size_t block = 2; block <= length; block <<= 1u) {
+        size_t half = block / 2;
+        uint32_t step = power_mod<MOD>(ROOT, static_cast<uint32_t>((MOD - 1) / block));
+        if (inverse) {
+            step = power_mod<MOD>(step, MOD - 2);
+        }
+        roots[0] = 1;
+        for (size_t i = 1; i < half; i++) {
+            roots[i] = static_cast<uint32_t>(static_cast<uint64_t>(roots[i - 1]) * step % MOD);
+        }
+        for (size_t i = 0; i < length; i += block) {
+            for (size_t j = 0; j < half; j++) {
+                uint32_t u = values[i + j];
+                uint32_t v = static_cast<uint32_t>(static_cast<uint64_t>(values[i + j + half]) * roots[j] % MOD);
+                values[i + j] = u + v < MOD ? u + v : u + v - MOD;
+                values[i + j + half] = u >= v ? u - v : u + MOD - v;
+            }
+        }
+    }
+    if (inverse) {
+        uint64_t scale = power_mod<MOD>(static_cast<uint32_t>(length), MOD - 2);
+        for (uint32_t &value : values) {
+            value = static_cast<uint32_t>(value * scale % MOD);
+        }
+    }
 }
 
-big_integer operator^(big_integer const &a, big_integer const &b) {
-    return bit_operation(a, b, [](uint32_t first, uint32_t second) { return first ^ second; });
+// cyclic convolution of first and second modulo MOD with the transform of the given length
+template<uint32_t MOD, uint32_t ROOT>
+static std::vector<uint32_t> convolution(uint32_t const *first, size_t first_length,
+                                         uint32_t const *second, size_t second_length, size_t length) {
+    bool square = first == second && first_length == second_length;
+    std::vector<uint32_t> first_values(length, 0), second_values;
+    for (size_t i = 0; i < first_length; i++) {
+        first_values[i] = first[i] % MOD;
+    }
+    ntt<MOD, ROOT>(first_values, false);
+    if (!square) {
+        second_values.assign(length, 0);
+        for (size_t i = 0; i < second_length; i++) {
+            second_values[i] = second[i] % MOD;
+        }
+        ntt<MOD, ROOT>(second_values, false);
+    }
+    std::vector<uint32_t> const &other_values = square ? first_values : second_values;
+    for (size_t i = 0; i < length; i++) {
+        first_values[i] = static_cast<uint32_t>(static_cast<uint64_t>(first_values[i]) * other_values[i] % MOD);
+    }
+    ntt<MOD, ROOT>(first_values, true);
+    return first_values;
 }
 
-big_integer operator<<(big_integer const &a, int b) {
-    if (b > 0) {
-        big_integer answer = a;
-        uint32_t small = b % 32, big = b / 32, short_multiply = (1u << small);
-        answer = increase(answer, short_multiply);
-        answer.reverse();
-        for (size_t i = 0; i < big; i++) {
-            answer.push_back(0);
-        }
-        answer.reverse();
-        answer.sign = a.sign;
-        return answer;
+// limbs are transformed as NTT_PIECES pieces of 32 bits each
+static const size_t NTT_PIECES = LIMB_BITS / 32;
+
+// convolution of 32-bit pieces is computed modulo three primes and restored by the chinese remainder theorem,
+// its terms are less than min(first_length, second_length) * NTT_PIECES * 2^64 < MOD1 * MOD2 * MOD3
+static void mul_ntt(limb_t *answer, limb_t const *first, size_t first_length,
+                    limb_t const *second, size_t second_length) {
+    static const uint32_t MOD1 = 998244353, MOD2 = 167772161, MOD3 = 469762049;
+    auto split = [](limb_t const *limbs, size_t limbs_length) {
+        std::vector<uint32_t> pieces(limbs_length * NTT_PIECES);
+        for (size_t i = 0; i < pieces.size(); i++) {
+            pieces[i] = static_cast<uint32_t>(limbs[i / NTT_PIECES] >> (32 * (i % NTT_PIECES)));
+        }
+        return pieces;
+    };
+    bool square = first == second && first_length == second_length;
+    std::vector<uint32_t> first_pieces = split(first, first_length);
+    std::vector<uint32_t> second_pieces = square ? std::vector<uint32_t>() : split(second, second_length);
+    uint32_t const *other = square ? first_pieces.data() : second_pieces.data();
+    size_t first_size = first_pieces.size(), second_size = second_length * NTT_PIECES;
+    size_t length = 1;
+    while (length < first_size + second_size) {
+        length <<= 1u;
+    }
+    std::vector<uint32_t> residues1 = convolution<MOD1, 3>(first_pieces.data(), first_size, other, second_size, length);
+    std::vector<uint32_t> residues2 = convolution<MOD2, 3>(first_pieces.data(), first_size, other, second_size, length);
+    std::vector<uint32_t> residues3 = convolution<MOD3, 3>(first_pieces.data(), first_size, other, second_size, length);
+
+    static const uint64_t MOD1_INVERSE = power_mod<MOD2>(MOD1, MOD2 - 2);
+    static const uint64_t MOD12_INVERSE = power_mod<MOD3>(static_cast<uint32_t>(
+            static_cast<uint64_t>(MOD1) * MOD2 % MOD3), MOD3 - 2);
+    static const uint64_t MOD12 = static_cast<uint64_t>(MOD1) * MOD2;
+    uint128_t carry = 0;
+    std::fill(answer, answer + first_length + second_length, 0);
+    for (size_t i = 0; i < first_size + second_size; i++) {
+        // term = r1 + MOD1 * x2 + MOD1 * MOD2 * x3
+        uint64_t r1 = residues1[i], r2 = residues2[i], r3 = residues3[i];
+        uint64_t x2 = (r2 + MOD2 - r1 % MOD2) * MOD1_INVERSE % MOD2;
+        uint64_t low = r1 + MOD1 * x2;
+        uint64_t x3 = (r3 + MOD3 - low % MOD3) * MOD12_INVERSE % MOD3;
+        carry += low + static_cast<uint128_t>(MOD12) * x3;
+        answer[i / NTT_PIECES] |= static_cast<limb_t>(static_cast<uint32_t>(carry)) << (32 * (i % NTT_PIECES));
+        carry >>= 32u;
+    }
+}
+
+// answer[0, first_length + second_length) = first * second, answer must not overlap with operands
+static void mul_limbs(limb_t *answer, limb_t const *first, size_t first_length,
+                      limb_t const *second, size_t second_length) {
+    if (first_length < second_length) {
+        std::swap(first, second);
+        std::swap(first_length, second_length);
+    }
+    if (first == second && first_length == second_length && first_length < KARATSUBA_SQR_THRESHOLD) {
+        sqr_basecase(answer, first, first_length);
+    } else if (second_length < KARATSUBA_THRESHOLD) {
+        mul_basecase(answer, first, first_length, second, second_length);
+    } else if (second_length >= NTT_THRESHOLD && (first_length + second_length) * NTT_PIECES <= NTT_MAX_LENGTH) {
+        mul_ntt(answer, first, first_length, second, second_length);
+    } else if (first_length >= 2 * second_length) {
+        // unbalanced operands: multiply second by chunks of first of the same length
+        std::fill(answer, answer + first_length + second_length, 0);
+        std::vector<limb_t> product(2 * second_length);
+        for (size_t i = 0; i < first_length; i += second_length) {
+            size_t chunk = std::min(second_length, first_length - i);
+            mul_limbs(product.data(), first + i, chunk, second, second_length);
+            add_limbs(answer + i, first_length + second_length - i, product.data(), chunk + second_length);
+        }
+    } else if (second_length < TOOM3_THRESHOLD) {
+        karatsuba(answer, first, first_length, second, second_length);
+    } else if (second_length < TOOM4_THRESHOLD) {
+        toom_cook(answer, first, first_length, second, second_length, 3);
     } else {
-        return a >> -b;
+        toom_cook(answer, first, first_length, second, second_length, 4);
     }
 }
 
-big_integer operator>>(big_integer const &a, int b) {
-    if (b > 0) {
-        big_integer answer = a;
-        uint32_t small = b % 32, big = b / 32, short_divide = (1u << small), length = answer.size();
-        answer.reverse();
-        for (size_t i = 0; i < std::min(big, length); i++) {
-            answer.bits.pop_back();
-        }
-        answer.reverse();
-        answer = short_div(answer, short_divide);
-        answer.sign = a.sign;
-        answer.normalise();
+big_integer operator*(big_integer const &a, big_integer const &b) {
+    big_integer answer;
+    if (a.size() == 0 || b.size() == 0) {
         return answer;
+    }
+    answer.allocate(a.size() + b.size());
+    // equal operands are passed as the same pointers, which every tier recognises as squaring
+    limb_t const *second = &a == &b || a.bits == b.bits ? a.bits.data() : b.bits.data();
+    mul_limbs(answer.bits.data(), a.bits.data(), a.size(), second, b.size());
+    answer.sign = a.sign ^ b.sign;
+    answer.normalise();
+    return answer;
+}
+
+// *this += first * second, or *this -= first * second if negative, without a temporary for the product:
+// a short operand is accumulated row by row, a long one by products of chunks as long as it.
+// The limbs are treated as a two's complement number that is negated back if the sum turns negative.
+// Neither operand may overlap with the limbs of *this
+void big_integer::add_product(limb_t const *first, size_t first_length,
+                              limb_t const *second, size_t second_length, bool negative) {
+    if (first_length < second_length) {
+        std::swap(first, second);
+        std::swap(first_length, second_length);
+    }
+    if (second_length == 0) {
+        return;
+    }
+    if (size() == 0) {
+        // nothing to accumulate into, the product is written in place
+        bits.resize(first_length + second_length);
+        mul_limbs(bits.data(), first, first_length, second, second_length);
+        sign = negative;
+        normalise();
+        return;
+    }
+    bool add = sign == negative;
+    // the top limb takes the carry of a sum, or is all ones if a difference turns negative
+    size_t length = std::max(size(), first_length + second_length) + 1;
+    bits.resize(length, 0);
+    limb_t *answer = bits.data();
+    if (second_length < KARATSUBA_THRESHOLD) {
+        for (size_t i = 0; i < second_length; i++) {
+            limb_t *row = answer + i;
+            limb_t high = add ? addmul_limbs(row, first, first_length, second[i])
+                              : submul_limbs(row, first, first_length, second[i]);
+            if (add) {
+                add_limbs(row + first_length, length - i - first_length, &high, 1);
+            } else {
+                sub_limbs(row + first_length, length - i - first_length, &high, 1);
+            }
+        }
     } else {
-        return a << -b;
+        std::vector<limb_t> product(2 * second_length);
+        for (size_t i = 0; i < first_length; i += second_length) {
+            size_t chunk = std::min(second_length, first_length - i);
+            mul_limbs(product.data(), first + i, chunk, second, second_length);
+            if (add) {
+                add_limbs(answer + i, length - i, product.data(), chunk + second_length);
+            } else {
+                sub_limbs(answer + i, length - i, product.data(), chunk + second_length);
+            }
+        }
+    }
+    if (!add && answer[length - 1]) {
+        for (size_t i = 0; i < length; i++) {
+            answer[i] = ~answer[i];
+        }
+        limb_t one = 1;
+        add_limbs(answer, length, &one, 1);
+        sign = negative;
+    }
+    normalise();
+}
+
+// to += a * b, equal operands are passed as the same pointers to be squared
+void addmul(big_integer &to, big_integer const &a, big_integer const &b) {
+    if (&to == &a || &to == &b) {
+        big_integer copy(to);
+        addmul(to, &to == &a ? copy : a, &to == &b ? copy : b);
+        return;
     }
+    limb_t const *second = &a == &b || a.bits == b.bits ? a.bits.data() : b.bits.data();
+    to.add_product(a.bits.data(), a.size(), second, b.size(), a.sign ^ b.sign);
 }
 
+// to -= a * b
+void submul(big_integer &to, big_integer const &a, big_integer const &b) {
+    if (&to == &a || &to == &b) {
+        big_integer copy(to);
+        submul(to, &to == &a ? copy : a, &to == &b ? copy : b);
+        return;
+    }
+    limb_t const *second = &a == &b || a.bits == b.bits ? a.bits.data() : b.bits.data();
+    to.add_product(a.bits.data(), a.size(), second, b.size(), !(a.sign ^ b.sign));
+}
 
-bool operator==(big_integer const &a, big_integer const &b) {
-    if (a.size() != b.size() || a.sign != b.sign) {
-        return false;
+// *this += value * (negative ? -magnitude : magnitude)
+void big_integer::add_native_product(big_integer const &value, uint64_t magnitude, bool negative) {
+    if (this == &value) {
+        big_integer copy(value);
+        add_native_product(copy, magnitude, negative);
+        return;
     }
-    for (size_t i = a.size(); i > 0; i--) {
-        if (a[i - 1] != b[i - 1]) {
-            return false;
+    limb_t limbs[NATIVE_LIMBS];
+    add_product(value.bits.data(), value.size(), limbs, split_native(limbs, magnitude), value.sign ^ negative);
+}
+
+// *this *= (negative ? -magnitude : magnitude) in place, unless the magnitude takes two limbs
+void big_integer::mul_native(uint64_t magnitude, bool negative) {
+    limb_t limbs[NATIVE_LIMBS];
+    size_t length = split_native(limbs, magnitude);
+    sign ^= negative;
+    if (length <= 1) {
+        mul_limb(length ? limbs[0] : 0);
+        return;
+    }
+    std::vector<limb_t> product(size() + length, 0);
+    mul_basecase(product.data(), bits.data(), size(), limbs, length);
+    bits.swap(product);
+    normalise();
+}
+// ==========================================================================================
+
+// =============================== Division starts here =====================================
+// divisors of this length (in limbs) and longer are divided by the recursive Burnikel-Ziegler algorithm
+static const size_t BURNIKEL_ZIEGLER_THRESHOLD = 80;
+// divisors and quotients of this length (in limbs) and longer are divided by multiplying by a Newton reciprocal
+static const size_t NEWTON_DIVISION_THRESHOLD = 20000;
+
+// quotient[0, length) = number[0, length) / divisor, returns the remainder; quotient may be number or null
+static limb_t div_limb(limb_t *quotient, limb_t const *number, size_t length, limb_t divisor) {
+    double_limb_t rest = 0;
+    for (size_t i = length; i > 0; i--) {
+        double_limb_t current = (rest << LIMB_BITS) | number[i - 1];
+        if (quotient) {
+            quotient[i - 1] = static_cast<limb_t>(current / divisor);
         }
+        rest = current % divisor;
     }
-    return true;
+    return static_cast<limb_t>(rest);
 }
 
-bool operator!=(big_integer const &a, big_integer const &b) {
-    return !(a == b);
+// Knuth's algorithm D: quotient[0, length - divisor_length) = numerator / divisor,
+// numerator[0, divisor_length) = numerator % divisor, the rest of numerator is zeroed;
+// divisor is normalised (its top bit is set) and numerator < divisor * B^(length - divisor_length)
+static void divide_basecase(limb_t *quotient, limb_t *numerator, size_t length,
+                            limb_t const *divisor, size_t divisor_length) {
+    limb_t const high = divisor[divisor_length - 1], low = divisor[divisor_length - 2];
+    for (size_t j = length - divisor_length; j > 0; j--) {
+        limb_t *window = numerator + j - 1;
+        double_limb_t top = (static_cast<double_limb_t>(window[divisor_length]) << LIMB_BITS) | window[divisor_length - 1];
+        double_limb_t estimate = std::min(top / high, static_cast<double_limb_t>(SMALL_BITS));
+        double_limb_t rest = top - estimate * high;
+        while (rest <= SMALL_BITS && estimate * low > ((rest << LIMB_BITS) | window[divisor_length - 2])) {
+            estimate--;
+            rest += high;
+        }
+        limb_t borrow = submul_limbs(window, divisor, divisor_length, static_cast<limb_t>(estimate));
+        limb_t top_limb = window[divisor_length];
+        window[divisor_length] = top_limb - borrow;
+        if (top_limb < borrow) {
+            estimate--;
+            add_limbs(window, divisor_length + 1, divisor, divisor_length);
+        }
+        quotient[j - 1] = static_cast<limb_t>(estimate);
+    }
 }
 
-bool operator<(big_integer const &a, big_integer const &b) {
-    if (a.sign != b.sign) {
-        return a.sign > b.sign;
+static void divide_2n_by_n(limb_t *quotient, limb_t *numerator, limb_t const *divisor, size_t length);
+
+// quotient[0, part) = numerator[0, length + part) / divisor[0, length),
+// the remainder is left in numerator[0, length), the rest of numerator is zeroed;
+// divisor is normalised, numerator < divisor * B^part and part <= length
+static void divide_3_by_2(limb_t *quotient, limb_t *numerator, limb_t const *divisor,
+                          size_t length, size_t part) {
+    if (part < BURNIKEL_ZIEGLER_THRESHOLD) {
+        divide_basecase(quotient, numerator, length + part, divisor, length);
+        return;
     }
-    if (a.size() != b.size()) {
-        return a.sign? a.size() > b.size() : a.size() < b.size();
+    // estimate the quotient by the top part limbs of divisor, it is at most 2 too large
+    size_t low_length = length - part;
+    limb_t const *divisor_high = divisor + low_length;
+    if (compare_limbs(numerator + length, part, divisor_high, part) < 0) {
+        divide_2n_by_n(quotient, numerator + low_length, divisor_high, part);
+    } else {
+        std::fill(quotient, quotient + part, SMALL_BITS);
+        std::fill(numerator + length, numerator + length + part, 0);
+        add_limbs(numerator + low_length, part + 1, divisor_high, part);
     }
-    for (int i = a.size(); i > 0; i--) {
-        if (a[i - 1] != b[i - 1]) {
-            return a.sign? a[i - 1] > b[i - 1]: a[i - 1] < b[i - 1];
+    // subtract quotient * divisor_low and add divisor back while the remainder is negative
+    if (low_length > 0) {
+        std::vector<limb_t> product(length);
+        mul_limbs(product.data(), quotient, part, divisor, low_length);
+        limb_t borrow = sub_limbs(numerator, length + 1, product.data(), length);
+        limb_t const one = 1;
+        while (borrow) {
+            borrow = !add_limbs(numerator, length + 1, divisor, length);
+            sub_limbs(quotient, part, &one, 1);
         }
     }
-    return false;
 }
 
-bool operator>(big_integer const &a, big_integer const &b) {
-    return b < a;
+// quotient[0, length) = numerator[0, 2 * length) / divisor[0, length),
+// the remainder is left in numerator[0, length), divisor is normalised and numerator < divisor * B^length
+static void divide_2n_by_n(limb_t *quotient, limb_t *numerator, limb_t const *divisor, size_t length) {
+    if (length < BURNIKEL_ZIEGLER_THRESHOLD) {
+        divide_basecase(quotient, numerator, 2 * length, divisor, length);
+        return;
+    }
+    size_t low = length / 2, high = length - low;
+    divide_3_by_2(quotient + low, numerator + low, divisor, length, high);
+    divide_3_by_2(quotient, numerator, divisor, length, low);
 }
 
-bool operator<=(big_integer const &a, big_integer const &b) {
-    return (a < b) || (a == b);
+// approximation of B^(2n) / divisor for a normalised divisor of n = length limbs, it differs by a few units at most;
+// the reciprocal of the top half of divisor is refined by one Newton step x + x * (B^(2n) - divisor * x) / B^(2n)
+static big_integer reciprocal(big_integer const &divisor, size_t length) {
+    if (length < NEWTON_DIVISION_THRESHOLD) {
+        return (big_integer(1) << static_cast<int>(2 * LIMB_BITS * length)) / divisor;
+    }
+    size_t high = length / 2 + 2, low = length - high;
+    big_integer approximation = reciprocal(divisor >> static_cast<int>(LIMB_BITS * low), high);
+    big_integer error = (big_integer(1) << static_cast<int>(2 * LIMB_BITS * length)) -
+                        ((divisor * approximation) << static_cast<int>(LIMB_BITS * low));
+    bool too_large = error < 0;
+    // only the top limbs of the error affect the correction
+    big_integer correction = approximation * (abs(error) >> static_cast<int>(LIMB_BITS * (length - 2)));
+    correction >>= static_cast<int>(LIMB_BITS * (high + 2));
+    approximation <<= static_cast<int>(LIMB_BITS * low);
+    return too_large ? approximation - correction : approximation + correction;
 }
 
-bool operator>=(big_integer const &a, big_integer const &b) {
-    return (a > b) || (a == b);
+// the same contract as divide_basecase for numerator of length limbs, the divisor is at least
+// NEWTON_DIVISION_THRESHOLD limbs; the quotient is found by blocks of divisor_length limbs
+// from the top, each block is estimated by the reciprocal and then corrected by a few units
+void divide_newton(limb_t *quotient, limb_t *numerator, size_t length,
+                   limb_t const *divisor, size_t divisor_length) {
+    big_integer d;
+    d.bits.assign(divisor, divisor + divisor_length);
+    big_integer inverse = reciprocal(d, divisor_length);
+    size_t part = length - divisor_length;
+    for (size_t end = part; end > 0;) {
+        size_t block = std::min(end, divisor_length), offset = end - block;
+        big_integer rest;
+        rest.bits.assign(numerator + offset, numerator + offset + divisor_length + block);
+        rest.normalise();
+        big_integer block_quotient = ((rest >> static_cast<int>(LIMB_BITS * (divisor_length - 1))) * inverse) >>
+                                     static_cast<int>(LIMB_BITS * (divisor_length + 1));
+        rest -= block_quotient * d;
+        while (rest < 0) {
+            rest += d;
+            block_quotient--;
+        }
+        while (rest >= d) {
+            rest -= d;
+            block_quotient++;
+        }
+        std::copy(block_quotient.bits.begin(), block_quotient.bits.end(), quotient + offset);
+        std::fill(numerator + offset, numerator + offset + divisor_length + block, 0);
+        std::copy(rest.bits.begin(), rest.bits.end(), numerator + offset);
+        end = offset;
+    }
 }
 
-std::string to_string(big_integer const &a) {
-    std::string answer;
-    big_integer decreased = a;
+// |a| = quotient * |b| + remainder
+void divide(big_integer const &a, big_integer const &b, big_integer &quotient, big_integer &remainder) {
+    if (b.size() == 0) {
+        throw std::runtime_error("division by zero");
+    }
+    quotient = big_integer();
+    remainder = abs(a);
+    if (compare_limbs(a.bits.data(), a.size(), b.bits.data(), b.size()) < 0) {
+        return;
+    }
+    size_t length = b.size();
+    if (length == 1) {
+        quotient.allocate(a.size());
+        limb_t rest = div_limb(quotient.bits.data(), a.bits.data(), a.size(), b[0]);
+        quotient.normalise();
+        remainder.assign_native(rest, false);
+        return;
+    }
+    // normalise the divisor so that its top bit is set, the numerator gets an extra limb for the shifted out bits
+    limb_t shift = 0;
+    while (!(b[length - 1] << shift & (limb_t(1) << (LIMB_BITS - 1)))) {
+        shift++;
+    }
+    auto shifted = [shift](big_integer const &number, size_t result_length) {
+        std::vector<limb_t> result(result_length, 0);
+        for (size_t i = 0; i < number.size(); i++) {
+            result[i] |= number[i] << shift;
+            if (shift) {
+                result[i + 1] = number[i] >> (LIMB_BITS - shift);
+            }
+        }
+        return result;
+    };
+    std::vector<limb_t> divisor = shifted(b, length + 1);
+    std::vector<limb_t> numerator = shifted(a, a.size() + 1);
+    size_t part = numerator.size() - length;
+    quotient.allocate(part);
+    if (length >= NEWTON_DIVISION_THRESHOLD && 2 * part >= length) {
+        divide_newton(quotient.bits.data(), numerator.data(), numerator.size(), divisor.data(), length);
+    } else if (length < BURNIKEL_ZIEGLER_THRESHOLD) {
+        divide_basecase(quotient.bits.data(), numerator.data(), numerator.size(), divisor.data(), length);
+    } else {
+        // the top quotient limbs that do not fill a whole block, then blocks of length limbs
+        size_t top = part % length ? part % length : length;
+        size_t blocks = (part - top) / length;
+        divide_3_by_2(quotient.bits.data() + blocks * length, numerator.data() + blocks * length,
+                      divisor.data(), length, top);
+        for (size_t i = blocks; i > 0; i--) {
+            divide_2n_by_n(quotient.bits.data() + (i - 1) * length, numerator.data() + (i - 1) * length,
+                           divisor.data(), length);
+        }
+    }
+    quotient.normalise();
+    remainder.allocate(length);
+    for (size_t i = 0; i < length; i++) {
+        remainder[i] = numerator[i] >> shift;
+        if (shift) {
+            remainder[i] |= numerator[i + 1] << (LIMB_BITS - shift);
+        }
+    }
+    remainder.normalise();
+}
+
+big_integer operator/(big_integer const &a, big_integer const &b) {
+    big_integer quotient, remainder;
+    divide(a, b, quotient, remainder);
+    quotient.sign = a.sign ^ b.sign;
+    quotient.normalise();
+    return quotient;
+}
+
+big_integer operator%(big_integer const &a, big_integer const &b) {
+    big_integer quotient, remainder;
+    divide(a, b, quotient, remainder);
+    remainder.sign = a.sign;
+    remainder.normalise();
+    return remainder;
+}
 
-    while (decreased.size()) {
-        big_integer const result = decreased % ten();
-        decreased /= ten();
-        uint32_t number = result[0];
-        answer.push_back(number + '0');
+// *this /= (negative ? -magnitude : magnitude) in place, rounding toward zero
+void big_integer::div_native(uint64_t magnitude, bool negative) {
+    if (magnitude == 0) {
+        throw std::runtime_error("division by zero");
     }
-    if (answer.empty()) {
-        return "0";
+    limb_t limbs[NATIVE_LIMBS];
+    size_t length = split_native(limbs, magnitude);
+    if (length == 1) {
+        div_limb(bits.data(), bits.data(), size(), limbs[0]);
+    } else {
+        big_integer divisor, quotient, rest;
+        divisor.bits.assign(limbs, limbs + length);
+        divide(*this, divisor, quotient, rest);
+        bits.swap(quotient.bits);
     }
-    if (a.sign) {
-        answer.push_back('-');
+    sign ^= negative;
+    normalise();
+}
+
+// the magnitude of *this % magnitude, *this is only read
+uint64_t big_integer::mod_native(uint64_t magnitude) const {
+    if (magnitude == 0) {
+        throw std::runtime_error("division by zero");
+    }
+    limb_t limbs[NATIVE_LIMBS];
+    size_t length = split_native(limbs, magnitude);
+    if (length == 1) {
+        return div_limb(nullptr, bits.data(), size(), limbs[0]);
+    }
+    // a two-limb divisor leaves a remainder of at most two limbs
+    big_integer divisor, quotient, rest;
+    divisor.bits.assign(limbs, limbs + length);
+    divide(*this, divisor, quotient, rest);
+    return static_cast<uint64_t>((static_cast<double_limb_t>(rest.return_value(1)) << LIMB_BITS) | rest.return_value(0));
+}
+
+// the quotient is rounded toward zero and the remainder has the sign of a, as by operator/ and operator%
+std::pair<big_integer, big_integer> divmod(big_integer const &a, big_integer const &b) {
+    std::pair<big_integer, big_integer> result;
+    divide(a, b, result.first, result.second);
+    result.first.sign = a.sign ^ b.sign;
+    result.first.normalise();
+    result.second.sign = a.sign;
+    result.second.normalise();
+    return result;
+}
+// ==========================================================================================
+
+// ================================ modular arithmetic ======================================
+// exponents longer than these (in bits) take windows of one more bit
+static const size_t WINDOW_BOUNDS[] = {7, 25, 81, 241, 673, 1793};
+
+// Barrett moduli shorter than this (in limbs) accumulate only the needed rows of both products
+static const size_t BARRETT_SHORT_THRESHOLD = 256;
+
+// answer = base^exponent for exponent[0, length) > 0 without leading zeros, by left-to-right sliding windows:
+// every window ends with a set bit and multiplies by one of the precomputed odd powers of base.
+// multiply(answer, a, b) sets answer = a * b and is passed the same object for a square
+template<typename Value, typename Multiply>
+static void sliding_window_pow(Value &answer, Value const &base, limb_t const *exponent, size_t length,
+                               Multiply multiply) {
+    size_t bits = length * LIMB_BITS;
+    while (!(exponent[length - 1] >> ((bits - 1) % LIMB_BITS) & 1)) {
+        bits--;
+    }
+    auto bit = [exponent](size_t index) -> unsigned {
+        return exponent[index / LIMB_BITS] >> (index % LIMB_BITS) & 1;
+    };
+    size_t width = 1;
+    for (size_t bound : WINDOW_BOUNDS) {
+        width += bits > bound;
+    }
+    // odd[i] = base^(2i + 1)
+    std::vector<Value> odd(size_t(1) << (width - 1), base);
+    Value square, product;
+    if (odd.size() > 1) {
+        multiply(square, base, base);
+        for (size_t i = 1; i < odd.size(); i++) {
+            multiply(odd[i], odd[i - 1], square);
+        }
+    }
+    bool started = false;
+    for (size_t i = bits; i > 0;) {
+        if (!bit(i - 1)) {
+            multiply(product, answer, answer);
+            std::swap(product, answer);
+            i--;
+            continue;
+        }
+        size_t window = std::min(width, i);
+        while (!bit(i - window)) {
+            window--;
+        }
+        size_t power = 0;
+        for (size_t j = i; j > i - window; j--) {
+            power = 2 * power + bit(j - 1);
+        }
+        if (started) {
+            for (size_t j = 0; j < window; j++) {
+                multiply(product, answer, answer);
+                std::swap(product, answer);
+            }
+            multiply(product, answer, odd[power / 2]);
+            std::swap(product, answer);
+        } else {
+            answer = odd[power / 2];
+            started = true;
+        }
+        i -= window;
+    }
+}
+
+montgomery_context::montgomery_context(big_integer const &modulus) : divisor(modulus), length(modulus.size()) {
+    if (modulus.sign || length == 0 || modulus[0] % 2 == 0) {
+        throw std::runtime_error("montgomery modulus must be odd and positive");
+    }
+    inverse = -limb_inverse(modulus[0]);
+    big_integer power = 1;
+    power <<= static_cast<int>(2 * length * LIMB_BITS);
+    r_squared = padded(power % modulus);
+}
+
+// (value mod modulus)[0, length), values outside of [0, modulus) are reduced first
+std::vector<limb_t> montgomery_context::padded(big_integer const &value) const {
+    if (value.sign || compare_limbs(value.bits.data(), value.size(), divisor.bits.data(), length) >= 0) {
+        big_integer reduced = value % divisor;
+        if (reduced.sign) {
+            reduced += divisor;
+        }
+        return padded(reduced);
+    }
+    std::vector<limb_t> limbs = value.bits;
+    limbs.resize(length, 0);
+    return limbs;
+}
+
+// answer[0, length) = product / R mod modulus for product[0, 2 length + 1) < modulus * R with a zero top limb:
+// adding q * modulus with q = product[i] * inverse clears the limbs one by one
+void montgomery_context::reduce(limb_t *answer, limb_t *product) const {
+    limb_t const *modulus = divisor.bits.data();
+    // the carry out of row i goes to limb i + length, what overflows that limb is kept for the next row
+    limb_t top = 0;
+    for (size_t i = 0; i < length; i++) {
+        limb_t carry = addmul_limbs(product + i, modulus, length, product[i] * inverse);
+        double_limb_t sum = static_cast<double_limb_t>(product[i + length]) + carry + top;
+        product[i + length] = remainder(sum);
+        top = static_cast<limb_t>(sum >> LIMB_BITS);
+    }
+    // what is left is below 2 * modulus
+    limb_t *rest = product + length;
+    rest[length] = top;
+    if (rest[length] || compare_limbs(rest, length, modulus, length) >= 0) {
+        sub_limbs(rest, length + 1, modulus, length);
+    }
+    std::copy(rest, rest + length, answer);
+}
+
+// answer[0, length) = a * b / R mod modulus, scratch holds 2 length + 1 limbs; a == b squares
+void montgomery_context::multiply(limb_t *answer, limb_t const *a, limb_t const *b, limb_t *scratch) const {
+    mul_limbs(scratch, a, length, b, length);
+    scratch[2 * length] = 0;
+    reduce(answer, scratch);
+}
+
+big_integer montgomery_context::multiply(big_integer const &a, big_integer const &b) const {
+    std::vector<limb_t> first = padded(a), second = padded(b), scratch(2 * length + 1);
+    big_integer answer;
+    answer.allocate(length);
+    multiply(answer.bits.data(), first.data(), &a == &b ? first.data() : second.data(), scratch.data());
+    answer.normalise();
+    return answer;
+}
+
+big_integer montgomery_context::square(big_integer const &a) const {
+    return multiply(a, a);
+}
+
+// value * R mod modulus
+big_integer montgomery_context::to_montgomery(big_integer const &value) const {
+    std::vector<limb_t> first = padded(value), scratch(2 * length + 1);
+    big_integer answer;
+    answer.allocate(length);
+    multiply(answer.bits.data(), first.data(), r_squared.data(), scratch.data());
+    answer.normalise();
+    return answer;
+}
+
+// value / R mod modulus
+big_integer montgomery_context::from_montgomery(big_integer const &value) const {
+    std::vector<limb_t> scratch = padded(value);
+    scratch.resize(2 * length + 1, 0);
+    big_integer answer;
+    answer.allocate(length);
+    reduce(answer.bits.data(), scratch.data());
+    answer.normalise();
+    return answer;
+}
+
+// base^exponent mod modulus, in [0, modulus)
+big_integer montgomery_context::pow(big_integer const &base, big_integer const &exponent) const {
+    if (exponent.sign) {
+        throw std::runtime_error("negative exponent");
+    }
+    if (exponent.size() == 0) {
+        return 1 % divisor;
+    }
+    std::vector<limb_t> scratch(2 * length + 1), answer;
+    std::vector<limb_t> montgomery_base = padded(to_montgomery(base));
+    sliding_window_pow(answer, montgomery_base, exponent.bits.data(), exponent.size(),
+                       [this, &scratch](std::vector<limb_t> &product, std::vector<limb_t> const &a,
+                                        std::vector<limb_t> const &b) {
+                           product.resize(length);
+                           multiply(product.data(), a.data(), b.data(), scratch.data());
+                       });
+    big_integer result;
+    result.bits = answer;
+    return from_montgomery(result);
+}
+
+modulus::modulus(big_integer const &value) : divisor(value), length(value.size()) {
+    if (value.sign || length == 0) {
+        throw std::runtime_error("modulus must be positive");
+    }
+    big_integer power = 1;
+    power <<= static_cast<int>(2 * length * LIMB_BITS);
+    inverse = (power / value).bits;
+    if (inverse.size() > length + 1) {
+        // m = B^(n - 1) gives exactly B^(n + 1), one less only costs an extra correction
+        inverse.assign(length + 1, SMALL_BITS);
+    }
+    inverse.resize(length + 1, 0);
+}
+
+bool modulus::is_reduced(big_integer const &value) const {
+    return !value.sign && compare_limbs(value.bits.data(), value.size(), divisor.bits.data(), length) < 0;
+}
+
+// answer[0, n + 1) = number[0, 2n) mod m with a zero top limb, scratch holds 4n + 3 limbs:
+// the quotient estimate (number / B^(n - 1)) * inverse / B^(n + 1) is at most 4 too small,
+// so the remainder is found modulo B^(n + 1) and corrected by a few subtractions.
+// Short operands only accumulate the rows that matter: the partial products of the estimate
+// under B^(n - 1) add up to less than one unit of the quotient, and the product by m is only needed modulo B^(n + 1)
+void modulus::reduce(limb_t *answer, limb_t const *number, limb_t *scratch) const {
+    limb_t const *m = divisor.bits.data(), *high = number + length - 1;
+    limb_t *estimate = scratch, *quotient = scratch + length + 1, *product = scratch + 2 * length + 2;
+    if (length < BARRETT_SHORT_THRESHOLD) {
+        std::fill(estimate, estimate + 2 * length + 2, 0);
+        for (size_t i = 0; i <= length; i++) {
+            size_t skip = i < length ? length - 1 - i : 0;
+            estimate[i + length + 1] = addmul_limbs(estimate + i + skip, inverse.data() + skip,
+                                                    length + 1 - skip, high[i]);
+        }
+        std::fill(product, product + length + 1, 0);
+        product[length] = addmul_limbs(product, m, length, quotient[0]);
+        for (size_t i = 1; i <= length; i++) {
+            addmul_limbs(product + i, m, length + 1 - i, quotient[i]);
+        }
+    } else {
+        mul_limbs(estimate, high, length + 1, inverse.data(), length + 1);
+        mul_limbs(product, quotient, length + 1, m, length);
+    }
+    std::copy(number, number + length + 1, answer);
+    sub_limbs(answer, length + 1, product, length + 1);
+    while (answer[length] || compare_limbs(answer, length, m, length) >= 0) {
+        sub_limbs(answer, length + 1, m, length);
+    }
+}
+
+// windows of 2n limbs are reduced from the top, each one is the previous remainder followed by
+// the next n limbs of value, as in schoolbook division
+big_integer modulus::reduce(big_integer const &value) const {
+    if (compare_limbs(value.bits.data(), value.size(), divisor.bits.data(), length) < 0) {
+        return value.sign ? value + divisor : value;
+    }
+    std::vector<limb_t> window(2 * length), scratch(4 * length + 3);
+    big_integer answer;
+    answer.allocate(length + 1);
+    limb_t const *number = value.bits.data();
+    size_t i = value.size(), chunk = std::min(i, 2 * length);
+    std::copy(number + i - chunk, number + i, window.begin());
+    for (;;) {
+        i -= chunk;
+        reduce(answer.bits.data(), window.data(), scratch.data());
+        if (i == 0) {
+            break;
+        }
+        chunk = std::min(i, length);
+        std::fill(window.begin(), window.end(), 0);
+        std::copy(number + i - chunk, number + i, window.begin());
+        std::copy(answer.bits.begin(), answer.bits.begin() + length, window.begin() + chunk);
+    }
+    answer.normalise();
+    if (value.sign && answer.size() != 0) {
+        answer = divisor - answer;
+    }
+    return answer;
+}
+
+big_integer modulus::mulmod(big_integer const &a, big_integer const &b) const {
+    big_integer first_reduced, second_reduced;
+    big_integer const *first = &a, *second = &b;
+    if (!is_reduced(a)) {
+        first_reduced = reduce(a);
+        first = &first_reduced;
+    }
+    if (&a == &b) {
+        second = first;
+    } else if (!is_reduced(b)) {
+        second_reduced = reduce(b);
+        second = &second_reduced;
+    }
+    big_integer answer;
+    if (first->size() == 0 || second->size() == 0) {
+        return answer;
+    }
+    // the product is below m^2 < B^(2n), a single window
+    std::vector<limb_t> product(2 * length, 0), scratch(4 * length + 3);
+    limb_t const *second_limbs = first == second || first->bits == second->bits ? first->bits.data()
+                                                                                 : second->bits.data();
+    mul_limbs(product.data(), first->bits.data(), first->size(), second_limbs, second->size());
+    answer.allocate(length + 1);
+    reduce(answer.bits.data(), product.data(), scratch.data());
+    answer.normalise();
+    return answer;
+}
+
+big_integer modulus::addmod(big_integer const &a, big_integer const &b) const {
+    big_integer answer = is_reduced(a) ? a : reduce(a);
+    answer += is_reduced(b) ? b : reduce(b);
+    if (compare(answer, divisor) >= 0) {
+        answer -= divisor;
+    }
+    return answer;
+}
+
+big_integer modulus::submod(big_integer const &a, big_integer const &b) const {
+    big_integer answer = is_reduced(a) ? a : reduce(a);
+    answer -= is_reduced(b) ? b : reduce(b);
+    if (answer.sign) {
+        answer += divisor;
+    }
+    return answer;
+}
+
+big_integer powmod(big_integer const &base, big_integer const &exponent, big_integer const &modulus) {
+    if (modulus.sign || modulus.size() == 0) {
+        throw std::runtime_error("modulus must be positive");
+    }
+    if (modulus[0] % 2) {
+        return montgomery_context(modulus).pow(base, exponent);
+    }
+    if (exponent.sign) {
+        throw std::runtime_error("negative exponent");
+    }
+    ::modulus barrett(modulus);
+    big_integer answer = barrett.reduce(1);
+    if (exponent.size() != 0) {
+        sliding_window_pow(answer, barrett.reduce(base), exponent.bits.data(), exponent.size(),
+                           [&barrett](big_integer &product, big_integer const &a, big_integer const &b) {
+                               product = barrett.mulmod(a, b);
+                           });
+    }
+    return answer;
+}
+// ==========================================================================================
+
+// ================================= powers ==================================================
+// the factors of two of base become one shift of the answer; an odd base of one limb is raised
+// by squarings and multiplications by its largest power that fits a limb, longer ones by sliding windows
+big_integer pow(big_integer const &base, uint64_t exponent) {
+    if (exponent == 0) {
+        return 1;
+    }
+    big_integer answer;
+    if (base.size() == 0) {
+        return answer;
+    }
+    size_t zeros = 0;
+    while (base[zeros / LIMB_BITS] == 0) {
+        zeros += LIMB_BITS;
+    }
+    zeros += __builtin_ctzll(base[zeros / LIMB_BITS]);
+    big_integer odd = base;
+    odd.shift_right(zeros);
+    if (odd.size() > 1) {
+        limb_t limbs[NATIVE_LIMBS];
+        size_t length = split_native(limbs, exponent);
+        sliding_window_pow(answer, odd, limbs, length,
+                           [](big_integer &product, big_integer const &a, big_integer const &b) {
+                               product = a * b;
+                           });
+    } else {
+        // factor^exponent = batch^(exponent / per_batch) * factor^(exponent % per_batch)
+        limb_t const factor = odd[0];
+        limb_t batch = factor, rest = 1;
+        uint64_t per_batch = 1;
+        while (factor > 1 && batch <= SMALL_BITS / factor) {
+            batch *= factor;
+            per_batch++;
+        }
+        for (uint64_t i = 0; i < exponent % per_batch; i++) {
+            rest *= factor;
+        }
+        uint64_t batches = exponent / per_batch;
+        answer.assign_native(rest, false);
+        if (batches) {
+            big_integer powers = 1;
+            for (uint64_t bit = uint64_t(1) << (63 - __builtin_clzll(batches)); bit; bit >>= 1) {
+                powers *= powers;
+                if (batches & bit) {
+                    powers.mul_limb(batch);
+                }
+            }
+            powers.mul_limb(rest);
+            answer = std::move(powers);
+        }
+    }
+    answer.shift_left(zeros * exponent);
+    answer.sign = base.sign && exponent % 2 == 1;
+    return answer;
+}
+// ==========================================================================================
+
+// ================================= factorials ==============================================
+// products of this many native factors and fewer are accumulated by single-limb multiplications
+static const size_t PRODUCT_LEAF = 16;
+// binomial(n, k) factors into primes when k is at least this fraction of n, otherwise it is a ratio of products
+static const uint64_t BINOMIAL_SIEVE_RATIO = 32;
+
+// the primes up to n by the sieve of Eratosthenes over odd numbers
+static std::vector<uint64_t> primes_up_to(uint64_t n) {
+    std::vector<uint64_t> primes;
+    if (n < 2) {
+        return primes;
+    }
+    primes.push_back(2);
+    // composite[i] is about 2i + 1
+    std::vector<bool> composite((n + 1) / 2, false);
+    for (uint64_t i = 1; 2 * i + 1 <= n; i++) {
+        if (composite[i]) {
+            continue;
+        }
+        uint64_t prime = 2 * i + 1;
+        primes.push_back(prime);
+        for (uint64_t multiple = prime * prime; multiple <= n; multiple += 2 * prime) {
+            composite[multiple / 2] = true;
+        }
+    }
+    return primes;
+}
+
+// the product of factors[begin, end) by a balanced tree, so that the multiplications have operands of near-equal
+// length and reach the fast multiplication tiers
+static big_integer product(std::vector<uint64_t> const &factors, size_t begin, size_t end) {
+    if (end - begin <= PRODUCT_LEAF) {
+        big_integer answer = 1;
+        for (size_t i = begin; i < end; i++) {
+            answer *= factors[i];
+        }
+        return answer;
+    }
+    size_t middle = begin + (end - begin) / 2;
+    return product(factors, begin, middle) * product(factors, middle, end);
+}
+
+static big_integer product(std::vector<uint64_t> const &factors) {
+    return product(factors, 0, factors.size());
+}
+
+// the odd part of n!, as the square of the odd part of (n / 2)! times the odd part of the swing n! / (n / 2)!^2:
+// every odd prime p divides the swing p^e times, with e the number of odd floor(n / p^i), and p^e <= n
+static big_integer odd_factorial(uint64_t n, std::vector<uint64_t> const &primes) {
+    if (n < 3) {
+        return 1;
+    }
+    big_integer half = odd_factorial(n / 2, primes);
+    std::vector<uint64_t> swing;
+    for (size_t i = 1; i < primes.size() && primes[i] <= n; i++) {
+        uint64_t factor = 1;
+        for (uint64_t quotient = n / primes[i]; quotient; quotient /= primes[i]) {
+            if (quotient & 1) {
+                factor *= primes[i];
+            }
+        }
+        if (factor > 1) {
+            swing.push_back(factor);
+        }
+    }
+    return half * half * product(swing);
+}
+
+big_integer factorial(uint64_t n) {
+    big_integer answer = odd_factorial(n, primes_up_to(n));
+    // n! has n minus the number of ones in n factors of two
+    answer <<= static_cast<int>(n - __builtin_popcountll(n));
+    return answer;
+}
+
+// the exponent of each prime is the number of carries when k and n - k are added in its base (Kummer's theorem),
+// and its power is at most n. Short ranges are the product of n - k + 1, ..., n divided by k!
+big_integer binomial(uint64_t n, uint64_t k) {
+    if (k > n) {
+        return 0;
+    }
+    k = std::min(k, n - k);
+    std::vector<uint64_t> factors;
+    if (k < n / BINOMIAL_SIEVE_RATIO) {
+        for (uint64_t i = 0; i < k; i++) {
+            factors.push_back(n - i);
+        }
+        return product(factors) / factorial(k);
+    }
+    for (uint64_t prime : primes_up_to(n)) {
+        uint64_t factor = 1;
+        for (uint64_t whole = n / prime, first = k / prime, second = (n - k) / prime; whole;
+             whole /= prime, first /= prime, second /= prime) {
+            for (uint64_t carries = whole - first - second; carries; carries--) {
+                factor *= prime;
+            }
+        }
+        if (factor > 1) {
+            factors.push_back(factor);
+        }
+    }
+    return product(factors);
+}
+
+big_integer primorial(uint64_t n) {
+    return product(primes_up_to(n));
+}
+// ==========================================================================================
+
+// ================================= gcd =====================================================
+// numbers of this length (in limbs) and longer are reduced by the half-gcd recursion instead of Lehmer steps
+static const size_t HALF_GCD_THRESHOLD = 120;
+// gcd takes half-gcd reductions of the top third of numbers of this length (in limbs) and longer
+static const size_t GCD_HALF_THRESHOLD = 240;
+
+// Lehmer's cofactors are kept below this, so that they fit a limb and multiply the numbers by addmul_limbs
+static const limb_t COFACTOR_LIMIT = limb_t(1) << (LIMB_BITS - 1);
+
+#if defined(BIG_INTEGER_LIMB_BITS) && BIG_INTEGER_LIMB_BITS == 64
+__extension__ typedef __int128 signed_double_limb_t;
+#else
+typedef int64_t signed_double_limb_t;
+#endif
+
+static unsigned bit_length(limb_t limb) {
+    return 64 - __builtin_clzll(static_cast<unsigned long long>(limb));
+}
+
+// number[0, length) >> shift, which fits 2 LIMB_BITS bits
+static double_limb_t top_bits(limb_t const *number, size_t length, size_t shift) {
+    size_t big = shift / LIMB_BITS;
+    unsigned small = shift % LIMB_BITS;
+    auto limb = [number, length](size_t index) -> double_limb_t {
+        return index < length ? number[index] : 0;
+    };
+    double_limb_t result = limb(big) | limb(big + 1) << LIMB_BITS;
+    if (small) {
+        result = result >> small | limb(big + 2) << (2 * LIMB_BITS - small);
+    }
+    return result;
+}
+
+// Knuth's algorithm L: cofactors {A, B, C, D} such that A a + B b and C a + D b are two consecutive remainders
+// of Euclid's algorithm on a >= b, found from the top 2 LIMB_BITS - 2 bits of both; a quotient is only taken
+// when both bounds on the true ratio agree on it. Returns whether any step was found
+static bool lehmer_matrix(limb_t const *a, size_t length, limb_t const *b, size_t b_length,
+                          int64_t (&cofactors)[4]) {
+    size_t bits = (length - 1) * LIMB_BITS + bit_length(a[length - 1]);
+    size_t shift = bits > 2 * LIMB_BITS - 2 ? bits - (2 * LIMB_BITS - 2) : 0;
+    signed_double_limb_t x = top_bits(a, length, shift), y = top_bits(b, b_length, shift);
+    signed_double_limb_t A = 1, B = 0, C = 0, D = 1;
+    while (y + C > 0 && y + D > 0) {
+        signed_double_limb_t quotient = (x + A) / (y + C);
+        if (quotient != (x + B) / (y + D) || quotient >= COFACTOR_LIMIT) {
+            break;
+        }
+        signed_double_limb_t next_c = A - quotient * C, next_d = B - quotient * D;
+        if (next_c >= COFACTOR_LIMIT || -next_c >= COFACTOR_LIMIT ||
+            next_d >= COFACTOR_LIMIT || -next_d >= COFACTOR_LIMIT) {
+            break;
+        }
+        A = C;
+        B = D;
+        C = next_c;
+        D = next_d;
+        signed_double_limb_t rest = x - quotient * y;
+        x = y;
+        y = rest;
+    }
+    cofactors[0] = static_cast<int64_t>(A);
+    cofactors[1] = static_cast<int64_t>(B);
+    cofactors[2] = static_cast<int64_t>(C);
+    cofactors[3] = static_cast<int64_t>(D);
+    return B != 0;
+}
+
+// answer[0, length] = x first + y second, known to be non-negative, so x and y are not both negative
+static void combine(limb_t *answer, limb_t const *first, limb_t const *second, size_t length, int64_t x, int64_t y) {
+    if (x < 0) {
+        std::swap(first, second);
+        std::swap(x, y);
+    }
+    std::fill(answer, answer + length, 0);
+    limb_t top = addmul_limbs(answer, first, length, static_cast<limb_t>(x));
+    if (y >= 0) {
+        top += addmul_limbs(answer, second, length, static_cast<limb_t>(y));
+    } else {
+        top -= submul_limbs(answer, second, length, static_cast<limb_t>(-y));
+    }
+    answer[length] = top;
+}
+
+// first = A a + B b and second = C a + D b for Lehmer's cofactors of a >= b, if there are any
+bool lehmer_step(big_integer const &a, big_integer const &b, big_integer &first, big_integer &second,
+                 int64_t (&cofactors)[4]) {
+    size_t length = a.size();
+    if (!lehmer_matrix(a.bits.data(), length, b.bits.data(), b.size(), cofactors)) {
+        return false;
+    }
+    std::vector<limb_t> padded = b.bits;
+    padded.resize(length, 0);
+    first.allocate(length + 1);
+    second.allocate(length + 1);
+    combine(first.bits.data(), a.bits.data(), padded.data(), length, cofactors[0], cofactors[1]);
+    combine(second.bits.data(), a.bits.data(), padded.data(), length, cofactors[2], cofactors[3]);
+    first.normalise();
+    second.normalise();
+    return true;
+}
+
+static uint64_t cofactor_magnitude(int64_t cofactor) {
+    return cofactor < 0 ? 0 - static_cast<uint64_t>(cofactor) : static_cast<uint64_t>(cofactor);
+}
+
+// the steps taken by a reduction: (a, b) = matrix (a', b') for the reduced pair (a', b');
+// the entries are non-negative and the determinant is 1, or -1 if odd, so that gcd(a, b) = gcd(a', b')
+struct gcd_matrix {
+    gcd_matrix() : odd(false) {
+        entry[0][0] = entry[1][1] = 1;
+    }
+
+    // a division step (a, b) -> (b, a - quotient b)
+    void push_quotient(big_integer const &quotient) {
+        for (auto &row : entry) {
+            addmul(row[1], row[0], quotient);
+            swap(row[0], row[1]);
+        }
+        odd = !odd;
+    }
+
+    // the steps of lehmer_step, the inverse of {A, B, C, D} is {|D|, |B|, |C|, |A|} up to the determinant
+    void push_lehmer(int64_t const (&cofactors)[4]) {
+        uint64_t a = cofactor_magnitude(cofactors[0]), b = cofactor_magnitude(cofactors[1]);
+        uint64_t c = cofactor_magnitude(cofactors[2]), d = cofactor_magnitude(cofactors[3]);
+        for (auto &row : entry) {
+            big_integer first = row[0] * d, second = row[0] * b;
+            addmul(first, row[1], c);
+            addmul(second, row[1], a);
+            row[0] = std::move(first);
+            row[1] = std::move(second);
+        }
+        // D alternates its sign with every step
+        odd ^= cofactors[3] < 0;
+    }
+
+    // (a, b) -> (b, a)
+    void push_swap() {
+        for (auto &row : entry) {
+            swap(row[0], row[1]);
+        }
+        odd = !odd;
+    }
+
+    void multiply(gcd_matrix const &other) {
+        for (auto &row : entry) {
+            big_integer first = row[0] * other.entry[0][0], second = row[0] * other.entry[0][1];
+            addmul(first, row[1], other.entry[1][0]);
+            addmul(second, row[1], other.entry[1][1]);
+            row[0] = std::move(first);
+            row[1] = std::move(second);
+        }
+        odd ^= other.odd;
+    }
+
+    // (x, y) = matrix^(-1) (x, y)
+    void apply_inverse(big_integer &x, big_integer &y) const {
+        big_integer first = entry[1][1] * x, second = entry[0][0] * y;
+        submul(first, entry[0][1], y);
+        submul(second, entry[1][0], x);
+        x = odd ? -std::move(first) : std::move(first);
+        y = odd ? -std::move(second) : std::move(second);
+    }
+
+    // one Lehmer or division step on a >= b that leaves both longer than bound limbs, returns whether it was taken
+    bool reduce_step(big_integer &a, big_integer &b, size_t bound) {
+        if (b.size() <= bound) {
+            return false;
+        }
+        int64_t cofactors[4];
+        big_integer first, second;
+        if (lehmer_step(a, b, first, second, cofactors) && second.size() > bound) {
+            a = std::move(first);
+            b = std::move(second);
+            push_lehmer(cofactors);
+            return true;
+        }
+        big_integer quotient, rest;
+        divide(a, b, quotient, rest);
+        if (rest.size() <= bound) {
+            return false;
+        }
+        a = std::move(b);
+        b = std::move(rest);
+        push_quotient(quotient);
+        return true;
+    }
+
+    // (a, b) = (high_a B^shift + a_low, high_b B^shift + b_low) where this matrix has reduced (high_a, high_b):
+    // the pair is replaced by (high_a', high_b') B^shift + matrix^(-1) (a_low, b_low), which is the reduced pair
+    // unless the quotients of the top parts differ from those of the whole numbers; then nothing changes
+    bool adjust(big_integer &a, big_integer &b, big_integer const &high_a, big_integer const &high_b, size_t shift) {
+        big_integer a_low, b_low;
+        a_low.bits.assign(a.bits.begin(), a.bits.begin() + std::min(shift, a.size()));
+        b_low.bits.assign(b.bits.begin(), b.bits.begin() + std::min(shift, b.size()));
+        a_low.normalise();
+        b_low.normalise();
+        apply_inverse(a_low, b_low);
+        a_low += high_a << static_cast<int>(shift * LIMB_BITS);
+        b_low += high_b << static_cast<int>(shift * LIMB_BITS);
+        if (a_low.sign || b_low.sign) {
+            return false;
+        }
+        a = std::move(a_low);
+        b = std::move(b_low);
+        if (a < b) {
+            swap(a, b);
+            push_swap();
+        }
+        return true;
+    }
+
+    // reduces the top limbs of a and b from shift on and applies the steps to the whole numbers
+    bool reduce_high(big_integer &a, big_integer &b, size_t shift) {
+        big_integer high_a = a >> static_cast<int>(shift * LIMB_BITS), high_b = b >> static_cast<int>(shift * LIMB_BITS);
+        gcd_matrix steps;
+        if (!steps.half_gcd(high_a, high_b) || !steps.adjust(a, b, high_a, high_b, shift)) {
+            return false;
+        }
+        multiply(steps);
+        return true;
+    }
+
+    // Euclid's steps on a >= b of n limbs while both stay longer than n / 2 + 1 limbs: the top half is reduced
+    // recursively, then single steps bring a to 3n / 4 limbs, and the top of what is left is reduced recursively again,
+    // so the entries of the matrix are about n / 2 limbs long. Returns whether any step was taken
+    bool half_gcd(big_integer &a, big_integer &b) {
+        size_t length = a.size(), bound = length / 2 + 1;
+        if (b.size() <= bound) {
+            return false;
+        }
+        bool progress = false;
+        if (length >= HALF_GCD_THRESHOLD) {
+            progress = reduce_high(a, b, length / 2);
+            while (a.size() > 3 * length / 4 + 1) {
+                if (!reduce_step(a, b, bound)) {
+                    return progress;
+                }
+                progress = true;
+            }
+            size_t rest = a.size();
+            if (rest > bound + 2 && b.size() > bound) {
+                progress |= reduce_high(a, b, 2 * bound - rest + 1);
+            }
+        }
+        while (reduce_step(a, b, bound)) {
+            progress = true;
+        }
+        return progress;
+    }
+
+    big_integer entry[2][2];
+
+    bool odd;
+};
+
+static unsigned trailing_zeros(double_limb_t value) {
+    limb_t low = remainder(value);
+    if (low) {
+        return __builtin_ctzll(low);
+    }
+    return LIMB_BITS + __builtin_ctzll(static_cast<limb_t>(value >> LIMB_BITS));
+}
+
+// Stein's binary gcd of two double limbs
+static double_limb_t binary_gcd(double_limb_t a, double_limb_t b) {
+    if (a == 0 || b == 0) {
+        return a | b;
+    }
+    unsigned shift = trailing_zeros(a | b);
+    a >>= trailing_zeros(a);
+    while (b) {
+        b >>= trailing_zeros(b);
+        if (a > b) {
+            std::swap(a, b);
+        }
+        b -= a;
+    }
+    return a << shift;
+}
+
+// a = gcd(a, b) and b = 0 for a >= b >= 0. The cofactors, if given, follow the steps: whatever multiple
+// of some number a and b are, cofactor and next_cofactor become the multiples for the new a and b.
+// Long numbers take half-gcd reductions of their top third, shorter ones Lehmer steps, and the last two limbs
+// are finished by the binary algorithm when there are no cofactors
+void gcd_reduce(big_integer &a, big_integer &b, big_integer *cofactor, big_integer *next_cofactor) {
+    while (b.size() > 0) {
+        if (!cofactor && a.size() <= 2) {
+            double_limb_t result = binary_gcd(static_cast<double_limb_t>(a.return_value(1)) << LIMB_BITS | a[0],
+                                              static_cast<double_limb_t>(b.return_value(1)) << LIMB_BITS | b[0]);
+            a.bits = {remainder(result), static_cast<limb_t>(result >> LIMB_BITS)};
+            a.normalise();
+            b = big_integer();
+            return;
+        }
+        if (a.size() >= GCD_HALF_THRESHOLD) {
+            gcd_matrix steps;
+            if (steps.reduce_high(a, b, 2 * a.size() / 3)) {
+                if (cofactor) {
+                    steps.apply_inverse(*cofactor, *next_cofactor);
+                }
+                continue;
+            }
+        }
+        int64_t cofactors[4];
+        big_integer first, second;
+        if (lehmer_step(a, b, first, second, cofactors)) {
+            a = std::move(first);
+            b = std::move(second);
+            if (cofactor) {
+                first = *cofactor * cofactors[0];
+                second = *cofactor * cofactors[2];
+                addmul(first, *next_cofactor, cofactors[1]);
+                addmul(second, *next_cofactor, cofactors[3]);
+                *cofactor = std::move(first);
+                *next_cofactor = std::move(second);
+            }
+            continue;
+        }
+        big_integer quotient, rest;
+        divide(a, b, quotient, rest);
+        a = std::move(b);
+        b = std::move(rest);
+        if (cofactor) {
+            submul(*cofactor, quotient, *next_cofactor);
+            swap(*cofactor, *next_cofactor);
+        }
+    }
+}
+
+big_integer gcd(big_integer const &a, big_integer const &b) {
+    big_integer first = abs(a), second = abs(b);
+    if (first < second) {
+        swap(first, second);
+    }
+    gcd_reduce(first, second, nullptr, nullptr);
+    return first;
+}
+
+big_integer lcm(big_integer const &a, big_integer const &b) {
+    if (a.size() == 0 || b.size() == 0) {
+        return big_integer();
+    }
+    return abs(a) / gcd(a, b) * abs(b);
+}
+
+// the multiple of |a| is followed through the reduction, the one of |b| is found by an exact division at the end
+big_integer gcdext(big_integer const &a, big_integer const &b, big_integer &x, big_integer &y) {
+    bool const a_negative = a.sign, b_negative = b.sign;
+    big_integer first = abs(a), second = abs(b);
+    bool swapped = first < second;
+    if (swapped) {
+        swap(first, second);
+    }
+    big_integer const first_value = first, second_value = second;
+    big_integer cofactor = 1, next_cofactor = 0;
+    gcd_reduce(first, second, &cofactor, &next_cofactor);
+    big_integer other;
+    if (second_value.size() != 0) {
+        other = first;
+        submul(other, cofactor, first_value);
+        other /= second_value;
+    }
+    if (swapped) {
+        swap(cofactor, other);
+    }
+    x = a_negative ? -std::move(cofactor) : std::move(cofactor);
+    y = b_negative ? -std::move(other) : std::move(other);
+    return first;
+}
+
+// only the multiple of a is followed, starting from modulus = 0 a (mod modulus) and a = 1 a
+big_integer invert(big_integer const &a, big_integer const &modulus) {
+    if (modulus.sign || modulus.size() == 0) {
+        throw std::runtime_error("modulus must be positive");
+    }
+    big_integer first = modulus, second = a % modulus;
+    if (second.sign) {
+        second += modulus;
+    }
+    big_integer cofactor = 0, next_cofactor = 1;
+    gcd_reduce(first, second, &cofactor, &next_cofactor);
+    if (first != 1) {
+        throw std::runtime_error("not invertible");
+    }
+    cofactor %= modulus;
+    if (cofactor.sign) {
+        cofactor += modulus;
+    }
+    return cofactor;
+}
+// ==========================================================================================
+
+// ================================= roots ===================================================
+// floor(sqrt(value)), by Newton's steps from above
+static double_limb_t sqrt_double_limb(double_limb_t value) {
+    if (value == 0) {
+        return 0;
+    }
+    unsigned bits = value >> LIMB_BITS ? LIMB_BITS + bit_length(static_cast<limb_t>(value >> LIMB_BITS))
+                                        : bit_length(remainder(value));
+    double_limb_t root = double_limb_t(1) << ((bits + 1) / 2);
+    for (;;) {
+        double_limb_t next = (root + value / root) / 2;
+        if (next >= root) {
+            return root;
+        }
+        root = next;
+    }
+}
+
+// root = floor(sqrt(value)) and rest = value - root^2 for value >= 0 by Zimmermann's Karatsuba square root,
+// which is Newton's iteration with the precision doubled on every level: value of n bits is split into
+// a3 2^(3l) + a2 2^(2l) + a1 2^l + a0 with l = (n - 1) / 4, the root of the top half is found recursively
+// and the next l bits of the root come from a division by twice of it, off by at most one
+void sqrt_rem(big_integer const &value, big_integer &root, big_integer &rest) {
+    if (value.size() <= 2) {
+        double_limb_t number = static_cast<double_limb_t>(value.return_value(1)) << LIMB_BITS | value.return_value(0);
+        double_limb_t result = sqrt_double_limb(number);
+        root.bits = {remainder(result), static_cast<limb_t>(result >> LIMB_BITS)};
+        root.sign = false;
+        root.normalise();
+        number -= result * result;
+        rest.bits = {remainder(number), static_cast<limb_t>(number >> LIMB_BITS)};
+        rest.sign = false;
+        rest.normalise();
+        return;
+    }
+    size_t bits = (value.size() - 1) * LIMB_BITS + bit_length(value.bits.back());
+    int const part = static_cast<int>((bits - 1) / 4);
+    big_integer high_root, high_rest;
+    sqrt_rem(value >> (2 * part), high_root, high_rest);
+    big_integer const mask = (big_integer(1) << part) - 1;
+    big_integer quotient, remainder;
+    divide((high_rest << part) + ((value >> part) & mask), high_root << 1, quotient, remainder);
+    root = (high_root << part) + quotient;
+    rest = (remainder << part) + (value & mask);
+    submul(rest, quotient, quotient);
+    if (rest.sign) {
+        rest += root;
+        root -= 1;
+        rest += root;
+    }
+}
+
+// floor(value^(1/k)) for value > 0 and k >= 3 by Newton's steps with the precision doubled on every level:
+// the root of value / 2^(k s) gives the top bits of the root and an estimate from above,
+// the guard bits make one step from it exact up to a unit in most cases. Short roots are found bit by bit
+big_integer root_floor(big_integer const &value, uint64_t k) {
+    size_t bits = (value.size() - 1) * LIMB_BITS + bit_length(value.bits.back());
+    size_t root_bits = (bits - 1) / k + 1;
+    if (root_bits == 1) {
+        return 1;
+    }
+    size_t guard = 67 - __builtin_clzll(k);
+    if (root_bits <= 2 * guard) {
+        big_integer root;
+        for (size_t i = root_bits; i > 0; i--) {
+            big_integer candidate = root + (big_integer(1) << static_cast<int>(i - 1));
+            if (pow(candidate, k) <= value) {
+                root = std::move(candidate);
+            }
+        }
+        return root;
+    }
+    size_t shift = (root_bits - guard) / 2;
+    big_integer root = (root_floor(value >> static_cast<int>(k * shift), k) + 1) << static_cast<int>(shift);
+    // the steps decrease while root is above the true root and never go below it,
+    // so the first one needs no check: it only stays in place at the true root
+    auto step = [&value, k](big_integer const &root, big_integer const &lower) {
+        return (root * (k - 1) + value / lower) / k;
+    };
+    big_integer next = step(root, pow(root, k - 1));
+    if (next >= root) {
+        return root;
+    }
+    root = std::move(next);
+    for (;;) {
+        big_integer lower = pow(root, k - 1);
+        if (lower * root <= value) {
+            return root;
+        }
+        next = step(root, lower);
+        root = next < root ? std::move(next) : root - 1;
+    }
+}
+
+big_integer isqrt(big_integer const &value) {
+    if (value.sign) {
+        throw std::runtime_error("square root of a negative number");
+    }
+    big_integer root, rest;
+    sqrt_rem(value, root, rest);
+    return root;
+}
+
+big_integer iroot(big_integer const &value, uint64_t k) {
+    if (k == 0) {
+        throw std::runtime_error("zeroth root");
+    }
+    if (value.sign && k % 2 == 0) {
+        throw std::runtime_error("even root of a negative number");
+    }
+    if (k == 1 || value.size() == 0) {
+        return value;
+    }
+    if (k == 2) {
+        return isqrt(value);
+    }
+    big_integer root = root_floor(abs(value), k);
+    return value.sign ? -std::move(root) : root;
+}
+// ==========================================================================================
+
+// spans of this many limbs and longer are combined by the vector kernels
+static const size_t SIMD_THRESHOLD = 16;
+
+// answer[i] = operation(first[i] ^ first_mask, second[i] ^ second_mask) ^ answer_mask by blocks of Vector,
+// null second stands for zero limbs; returns the number of limbs done.
+// Always inlined, so that the target-specific callers below compile it with their vector instructions
+template<typename Vector, typename Operation>
+__attribute__((always_inline))
+static inline size_t bitwise_block(limb_t *answer, limb_t const *first, limb_t const *second, size_t length,
+                                   limb_t first_mask, limb_t second_mask, limb_t answer_mask, Operation operation) {
+    size_t const step = sizeof(Vector) / sizeof(limb_t);
+    Vector first_masks, second_masks, answer_masks, zero;
+    std::memset(&first_masks, first_mask ? 0xFF : 0, sizeof(Vector));
+    std::memset(&second_masks, second_mask ? 0xFF : 0, sizeof(Vector));
+    std::memset(&answer_masks, answer_mask ? 0xFF : 0, sizeof(Vector));
+    std::memset(&zero, 0, sizeof(Vector));
+    size_t i = 0;
+    for (; i + step <= length; i += step) {
+        Vector x, y = zero;
+        std::memcpy(&x, first + i, sizeof(Vector));
+        if (second) {
+            std::memcpy(&y, second + i, sizeof(Vector));
+        }
+        x ^= first_masks;
+        y ^= second_masks;
+        operation(x, y);
+        x ^= answer_masks;
+        std::memcpy(answer + i, &x, sizeof(Vector));
+    }
+    return i;
+}
+
+#ifdef BIG_INTEGER_SIMD
+typedef long long vector256 __attribute__((vector_size(32)));
+typedef long long vector512 __attribute__((vector_size(64)));
+
+template<typename Operation>
+__attribute__((target("avx2")))
+static size_t bitwise_avx2(limb_t *answer, limb_t const *first, limb_t const *second, size_t length,
+                           limb_t first_mask, limb_t second_mask, limb_t answer_mask, Operation operation) {
+    return bitwise_block<vector256>(answer, first, second, length, first_mask, second_mask, answer_mask, operation);
+}
+
+template<typename Operation>
+__attribute__((target("avx512f")))
+static size_t bitwise_avx512(limb_t *answer, limb_t const *first, limb_t const *second, size_t length,
+                             limb_t first_mask, limb_t second_mask, limb_t answer_mask, Operation operation) {
+    return bitwise_block<vector512>(answer, first, second, length, first_mask, second_mask, answer_mask, operation);
+}
+
+enum class simd_level {
+    none, avx2, avx512
+};
+
+static simd_level detect_simd() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return simd_level::avx512;
+    }
+    return __builtin_cpu_supports("avx2") ? simd_level::avx2 : simd_level::none;
+}
+#endif
+
+// bitwise_block over all limbs, with the widest vectors the processor supports for long spans
+template<typename Operation>
+static void bitwise_limbs(limb_t *answer, limb_t const *first, limb_t const *second, size_t length,
+                          limb_t first_mask, limb_t second_mask, limb_t answer_mask, Operation operation) {
+    size_t done = 0;
+#ifdef BIG_INTEGER_SIMD
+    static const simd_level level = detect_simd();
+    if (length >= SIMD_THRESHOLD && level == simd_level::avx512) {
+        done = bitwise_avx512(answer, first, second, length, first_mask, second_mask, answer_mask, operation);
+    } else if (length >= SIMD_THRESHOLD && level == simd_level::avx2) {
+        done = bitwise_avx2(answer, first, second, length, first_mask, second_mask, answer_mask, operation);
+    }
+#endif
+    bitwise_block<limb_t>(answer + done, first + done, second ? second + done : nullptr, length - done,
+                          first_mask, second_mask, answer_mask, operation);
+}
+
+// answer = operation(a, b) applied to the infinite two's complement forms of a and b;
+// a negative number is ~magnitude + 1, its limbs are produced one by one together with the carry of the increment,
+// and the result is turned back into sign and magnitude the same way; answer may be the same object as a or b.
+// The increments stop carrying at the first non-zero limb, from there on the limbs are independent
+// and go to the vectorised kernel
+template<typename Operation>
+void bit_operation(big_integer &answer, big_integer const &a, big_integer const &b, Operation operation) {
+    size_t first_length = a.size(), second_length = b.size();
+    size_t length = std::max(first_length, second_length) + 1;
+    limb_t const first_mask = a.sign ? SMALL_BITS : 0, second_mask = b.sign ? SMALL_BITS : 0;
+    limb_t answer_mask = first_mask;
+    operation(answer_mask, second_mask);
+    limb_t first_carry = first_mask & 1u, second_carry = second_mask & 1u, answer_carry = answer_mask & 1u;
+    answer.bits.resize(length, 0);
+    limb_t *result = answer.bits.data();
+    limb_t const *first = a.bits.data(), *second = b.bits.data();
+    size_t i = 0;
+    auto carrying_step = [&]() {
+        limb_t x = i < first_length ? first[i] : 0, y = i < second_length ? second[i] : 0;
+        limb_t limb = (x ^ first_mask) + first_carry;
+        operation(limb, (y ^ second_mask) + second_carry);
+        first_carry &= x == 0;
+        second_carry &= y == 0;
+        result[i] = (limb ^ answer_mask) + answer_carry;
+        answer_carry &= limb == 0;
+    };
+    for (; i < length && (first_carry | second_carry | answer_carry); i++) {
+        carrying_step();
+    }
+    size_t common = std::min(first_length, second_length), longer = length - 1;
+    if (i < common) {
+        bitwise_limbs(result + i, first + i, second + i, common - i, first_mask, second_mask, answer_mask, operation);
+        i = common;
+    }
+    if (i < longer) {
+        // only the longer operand has limbs here, the operations are symmetric
+        if (first_length > second_length) {
+            bitwise_limbs(result + i, first + i, nullptr, longer - i, first_mask, second_mask, answer_mask, operation);
+        } else {
+            bitwise_limbs(result + i, second + i, nullptr, longer - i, second_mask, first_mask, answer_mask, operation);
+        }
+        i = longer;
+    }
+    for (; i < length; i++) {
+        carrying_step();
+    }
+    answer.sign = answer_mask != 0;
+    answer.normalise();
+}
+
+big_integer operator&(big_integer const &a, big_integer const &b) {
+    big_integer answer;
+    bit_operation(answer, a, b, and_operation());
+    return answer;
+}
+
+big_integer operator|(big_integer const &a, big_integer const &b) {
+    big_integer answer;
+    bit_operation(answer, a, b, or_operation());
+    return answer;
+}
+
+big_integer operator^(big_integer const &a, big_integer const &b) {
+    big_integer answer;
+    bit_operation(answer, a, b, xor_operation());
+    return answer;
+}
+
+big_integer operator&(big_integer &&a, big_integer const &b) {
+    a &= b;
+    return std::move(a);
+}
+
+big_integer operator&(big_integer const &a, big_integer &&b) {
+    b &= a;
+    return std::move(b);
+}
+
+big_integer operator&(big_integer &&a, big_integer &&b) {
+    a &= b;
+    return std::move(a);
+}
+
+big_integer operator|(big_integer &&a, big_integer const &b) {
+    a |= b;
+    return std::move(a);
+}
+
+big_integer operator|(big_integer const &a, big_integer &&b) {
+    b |= a;
+    return std::move(b);
+}
+
+big_integer operator|(big_integer &&a, big_integer &&b) {
+    a |= b;
+    return std::move(a);
+}
+
+big_integer operator^(big_integer &&a, big_integer const &b) {
+    a ^= b;
+    return std::move(a);
+}
+
+big_integer operator^(big_integer const &a, big_integer &&b) {
+    b ^= a;
+    return std::move(b);
+}
+
+big_integer operator^(big_integer &&a, big_integer &&b) {
+    a ^= b;
+    return std::move(a);
+}
+
+// magnitude <<= shift in place: the whole limbs move up by memmove, the remaining bits are funnel-shifted
+// from the top so that no limb is overwritten before it is read
+void big_integer::shift_left(size_t shift) {
+    if (size() == 0) {
+        return;
+    }
+    size_t big = shift / LIMB_BITS, length = size();
+    unsigned small = shift % LIMB_BITS;
+    if (small == 0) {
+        bits.resize(length + big);
+        std::memmove(bits.data() + big, bits.data(), length * sizeof(limb_t));
+    } else {
+        bits.resize(length + big + 1);
+        limb_t *data = bits.data();
+        data[length + big] = data[length - 1] >> (LIMB_BITS - small);
+        for (size_t i = length - 1; i > 0; i--) {
+            data[i + big] = (data[i] << small) | (data[i - 1] >> (LIMB_BITS - small));
+        }
+        data[big] = data[0] << small;
+    }
+    std::fill(bits.begin(), bits.begin() + big, 0);
+    normalise();
+}
+
+// magnitude >>= shift in place, the limbs are moved from the bottom;
+// returns whether any of the dropped bits was nonzero
+bool big_integer::shift_right(size_t shift) {
+    size_t big = shift / LIMB_BITS;
+    unsigned small = shift % LIMB_BITS;
+    if (big >= size()) {
+        bool dropped = size() > 0;
+        bits.clear();
+        normalise();
+        return dropped;
+    }
+    limb_t *data = bits.data();
+    bool dropped = std::any_of(data, data + big, [](limb_t limb) { return limb != 0; });
+    size_t length = size() - big;
+    if (small == 0) {
+        std::memmove(data, data + big, length * sizeof(limb_t));
+    } else {
+        dropped |= (data[big] << (LIMB_BITS - small)) != 0;
+        for (size_t i = 0; i + 1 < length; i++) {
+            data[i] = (data[i + big] >> small) | (data[i + big + 1] << (LIMB_BITS - small));
+        }
+        data[length - 1] = data[length - 1 + big] >> small;
+    }
+    bits.resize(length);
+    normalise();
+    return dropped;
+}
+
+big_integer operator<<(big_integer const &a, int b) {
+    big_integer answer = a;
+    answer <<= b;
+    return answer;
+}
+
+big_integer operator>>(big_integer const &a, int b) {
+    big_integer answer = a;
+    answer >>= b;
+    return answer;
+}
+
+big_integer operator<<(big_integer &&a, int b) {
+    a <<= b;
+    return std::move(a);
+}
+
+big_integer operator>>(big_integer &&a, int b) {
+    a >>= b;
+    return std::move(a);
+}
+
+
+// -1, 0 or 1 as a is less than, equal to or greater than b
+int compare(big_integer const &a, big_integer const &b) {
+    if (a.sign != b.sign) {
+        return a.sign ? -1 : 1;
+    }
+    int magnitude = compare_limbs(a.bits.data(), a.size(), b.bits.data(), b.size());
+    return a.sign ? -magnitude : magnitude;
+}
+
+bool operator==(big_integer const &a, big_integer const &b) {
+    return compare(a, b) == 0;
+}
+
+bool operator!=(big_integer const &a, big_integer const &b) {
+    return compare(a, b) != 0;
+}
+
+bool operator<(big_integer const &a, big_integer const &b) {
+    return compare(a, b) < 0;
+}
+
+bool operator>(big_integer const &a, big_integer const &b) {
+    return compare(a, b) > 0;
+}
+
+bool operator<=(big_integer const &a, big_integer const &b) {
+    return compare(a, b) <= 0;
+}
+
+bool operator>=(big_integer const &a, big_integer const &b) {
+    return compare(a, b) >= 0;
+}
+
+// numbers of this length (in limbs) and longer are converted to decimal by halves
+static const size_t TO_STRING_THRESHOLD = 60;
+// strings of this length and longer are parsed by halves
+static const size_t FROM_STRING_THRESHOLD = 600;
+// decimal digits taken at a time, DECIMAL_CHUNK = 10^DECIMAL_DIGITS
+static const size_t DECIMAL_DIGITS = 9;
+static const uint32_t DECIMAL_CHUNK = 1000000000;
+
+// appends decimal digits of |value| padded with leading zeros up to width;
+// powers[level] = 10^(9 * 2^level), built by the caller for the length of the whole number
+void to_decimal(std::string &answer, big_integer const &value, size_t width, std::vector<big_integer> const &powers) {
+    if (value.size() < TO_STRING_THRESHOLD) {
+        // divide by 10^9 in place, each remainder gives nine digits
+        std::vector<limb_t> rest(value.bits);
+        std::string digits;
+        while (!rest.empty()) {
+            uint64_t chunk = 0;
+            for (size_t i = rest.size(); i > 0; i--) {
+                // limbs are divided by 32-bit halves, so that the dividend fits into 64 bits
+                limb_t quotient = 0;
+                for (size_t j = LIMB_BITS / 32; j > 0; j--) {
+                    uint64_t current = (chunk << 32u) | static_cast<uint32_t>(rest[i - 1] >> (32 * (j - 1)));
+                    quotient |= static_cast<limb_t>(current / DECIMAL_CHUNK) << (32 * (j - 1));
+                    chunk = current % DECIMAL_CHUNK;
+                }
+                rest[i - 1] = quotient;
+            }
+            while (!rest.empty() && rest.back() == 0) {
+                rest.pop_back();
+            }
+            for (size_t i = 0; i < DECIMAL_DIGITS; i++) {
+                digits.push_back(static_cast<char>('0' + chunk % 10));
+                chunk /= 10;
+            }
+        }
+        while (!digits.empty() && digits.back() == '0') {
+            digits.pop_back();
+        }
+        if (digits.size() < width) {
+            digits.resize(width, '0');
+        }
+        answer.append(digits.rbegin(), digits.rend());
+        return;
+    }
+    // split by the largest power of ten whose square has at most half the limbs, squares being twice as long
+    size_t level = 0;
+    while (level + 1 < powers.size() && 4 * powers[level].size() <= value.size()) {
+        level++;
+    }
+    size_t low_width = DECIMAL_DIGITS << level;
+    auto parts = divmod(value, powers[level]);
+    to_decimal(answer, parts.first, width > low_width ? width - low_width : 0, powers);
+    to_decimal(answer, parts.second, low_width, powers);
+}
+
+// value = the non-negative number written by digits[0, length), powers[level] = 10^(9 * 2^level)
+void from_decimal(big_integer &value, char const *digits, size_t length, std::vector<big_integer> const &powers) {
+    if (length < FROM_STRING_THRESHOLD) {
+        // value = value * 10^9 + chunk in place for every nine digits, the first chunk takes the rest
+        value.bits.clear();
+        value.sign = false;
+        for (size_t i = 0; i < length;) {
+            size_t chunk_length = i == 0 && length % DECIMAL_DIGITS ? length % DECIMAL_DIGITS : DECIMAL_DIGITS;
+            uint32_t chunk = 0, factor = 1;
+            for (size_t j = 0; j < chunk_length; j++) {
+                chunk = chunk * 10 + (digits[i + j] - '0');
+                factor *= 10;
+            }
+            double_limb_t carry = chunk;
+            for (limb_t &limb : value.bits) {
+                double_limb_t current = static_cast<double_limb_t>(limb) * factor + carry;
+                limb = remainder(current);
+                carry = current >> LIMB_BITS;
+            }
+            if (carry) {
+                value.push_back(static_cast<limb_t>(carry));
+            }
+            i += chunk_length;
+        }
+        return;
+    }
+    // the low part takes 9 * 2^level digits, about a half
+    size_t level = 0;
+    while (2 * (DECIMAL_DIGITS << (level + 1)) <= length) {
+        level++;
+    }
+    size_t low_width = DECIMAL_DIGITS << level;
+    big_integer high, low;
+    from_decimal(high, digits, length - low_width, powers);
+    from_decimal(low, digits + length - low_width, low_width, powers);
+    value = high * powers[level] + low;
+}
+
+// the powers of ten are built per call, each as the square of the previous one, up to the largest split level
+void from_decimal(big_integer &value, char const *digits, size_t length) {
+    std::vector<big_integer> powers{big_integer(static_cast<int>(DECIMAL_CHUNK))};
+    if (length >= FROM_STRING_THRESHOLD) {
+        while (2 * (DECIMAL_DIGITS << powers.size()) <= length) {
+            powers.push_back(powers.back() * powers.back());
+        }
+    }
+    from_decimal(value, digits, length, powers);
+}
+
+std::string to_string(big_integer const &a) {
+    if (a.size() == 0) {
+        return "0";
+    }
+    std::string answer;
+    if (a.sign) {
+        answer.push_back('-');
+    }
+    std::vector<big_integer> powers{big_integer(static_cast<int>(DECIMAL_CHUNK))};
+    if (a.size() >= TO_STRING_THRESHOLD) {
+        while (4 * powers.back().size() <= a.size()) {
+            powers.push_back(powers.back() * powers.back());
+        }
     }
-    reverse(answer.begin(), answer.end());
+    to_decimal(answer, a, 0, powers);
     return answer;
 }
 
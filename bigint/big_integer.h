@@ -9,6 +9,24 @@
 #include <string>
 #include <iostream>
 #include <functional>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+
+// limbs are 32-bit with 64-bit products by default,
+// building with BIG_INTEGER_LIMB_BITS=64 gives 64-bit limbs with unsigned __int128 products
+#if defined(BIG_INTEGER_LIMB_BITS) && BIG_INTEGER_LIMB_BITS == 64
+typedef uint64_t limb_t;
+__extension__ typedef unsigned __int128 double_limb_t;
+#else
+typedef uint32_t limb_t;
+typedef uint64_t double_limb_t;
+#endif
+
+// native integers are widened to int64_t or uint64_t when big_integer operators take them directly
+template<typename T>
+using native_integer = typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value,
+        typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type>::type;
 
 struct big_integer {
 
@@ -16,6 +34,8 @@ struct big_integer {
 
     big_integer(big_integer const &other);
 
+    big_integer(big_integer &&other) noexcept;
+
     big_integer(int a);
 
     big_integer(std::string const &str);
@@ -24,6 +44,8 @@ struct big_integer {
 
     big_integer &operator=(big_integer const &other);
 
+    big_integer &operator=(big_integer &&other) noexcept;
+
     big_integer &operator+=(big_integer const &rhs);
 
     big_integer &operator-=(big_integer const &rhs);
@@ -44,11 +66,46 @@ struct big_integer {
 
     big_integer &operator>>=(int rhs);
 
+    // native operands are handled in place by single-limb kernels, without building a big_integer
+    template<typename T, typename Native = native_integer<T>>
+    big_integer &operator+=(T rhs) {
+        add_native(native_magnitude(Native(rhs)), native_negative(Native(rhs)));
+        return *this;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    big_integer &operator-=(T rhs) {
+        add_native(native_magnitude(Native(rhs)), !native_negative(Native(rhs)));
+        return *this;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    big_integer &operator*=(T rhs) {
+        mul_native(native_magnitude(Native(rhs)), native_negative(Native(rhs)));
+        return *this;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    big_integer &operator/=(T rhs) {
+        div_native(native_magnitude(Native(rhs)), native_negative(Native(rhs)));
+        return *this;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    big_integer &operator%=(T rhs) {
+        assign_native(mod_native(native_magnitude(Native(rhs))), sign);
+        return *this;
+    }
+
     big_integer operator+() const;
 
-    big_integer operator-() const;
+    big_integer operator-() const &;
+
+    big_integer operator-() &&;
+
+    big_integer operator~() const &;
 
-    big_integer operator~() const;
+    big_integer operator~() &&;
 
     big_integer &operator++();
 
@@ -58,6 +115,8 @@ struct big_integer {
 
     big_integer operator--(int);
 
+    friend int compare(big_integer const &a, big_integer const &b);
+
     friend bool operator==(big_integer const &a, big_integer const &b);
 
     friend bool operator!=(big_integer const &a, big_integer const &b);
@@ -81,24 +140,89 @@ struct big_integer {
 
     friend big_integer operator+(big_integer const &a, big_integer const &b);
 
+    friend big_integer operator+(big_integer &&a, big_integer const &b);
+
+    friend big_integer operator+(big_integer const &a, big_integer &&b);
+
+    friend big_integer operator+(big_integer &&a, big_integer &&b);
+
     friend big_integer operator-(big_integer const &a, big_integer const &b);
 
+    friend big_integer operator-(big_integer &&a, big_integer const &b);
+
+    friend big_integer operator-(big_integer const &a, big_integer &&b);
+
+    friend big_integer operator-(big_integer &&a, big_integer &&b);
+
     friend big_integer operator*(big_integer const &a, big_integer const &b);
 
     friend big_integer operator/(big_integer const &a, big_integer const &b);
 
     friend big_integer operator%(big_integer const &a, big_integer const &b);
 
+    friend std::pair<big_integer, big_integer> divmod(big_integer const &a, big_integer const &b);
+
+    // to += a * b and to -= a * b, accumulated into the limbs of to without a temporary for the product
+    friend void addmul(big_integer &to, big_integer const &a, big_integer const &b);
+
+    friend void submul(big_integer &to, big_integer const &a, big_integer const &b);
+
+    // base^exponent mod modulus in [0, modulus) for exponent >= 0 and modulus > 0,
+    // odd moduli are handled in Montgomery form, even ones by Barrett reduction
+    friend big_integer powmod(big_integer const &base, big_integer const &exponent, big_integer const &modulus);
+
+    // base^exponent, 0^0 = 1
+    friend big_integer pow(big_integer const &base, uint64_t exponent);
+
+    // the greatest common divisor and the least common multiple of |a| and |b|, both non-negative
+    friend big_integer gcd(big_integer const &a, big_integer const &b);
+
+    friend big_integer lcm(big_integer const &a, big_integer const &b);
+
+    // returns gcd(a, b) and sets x and y so that a * x + b * y = gcd(a, b)
+    friend big_integer gcdext(big_integer const &a, big_integer const &b, big_integer &x, big_integer &y);
+
+    // the inverse of a modulo modulus > 0 in [0, modulus), throws if gcd(a, modulus) != 1
+    friend big_integer invert(big_integer const &a, big_integer const &modulus);
+
+    // floor(sqrt(value)) for value >= 0
+    friend big_integer isqrt(big_integer const &value);
+
+    // the k-th root of value rounded toward zero for k >= 1, value may only be negative for odd k
+    friend big_integer iroot(big_integer const &value, uint64_t k);
+
     friend big_integer operator&(big_integer const &a, big_integer const &b);
 
+    friend big_integer operator&(big_integer &&a, big_integer const &b);
+
+    friend big_integer operator&(big_integer const &a, big_integer &&b);
+
+    friend big_integer operator&(big_integer &&a, big_integer &&b);
+
     friend big_integer operator|(big_integer const &a, big_integer const &b);
 
+    friend big_integer operator|(big_integer &&a, big_integer const &b);
+
+    friend big_integer operator|(big_integer const &a, big_integer &&b);
+
+    friend big_integer operator|(big_integer &&a, big_integer &&b);
+
     friend big_integer operator^(big_integer const &a, big_integer const &b);
 
+    friend big_integer operator^(big_integer &&a, big_integer const &b);
+
+    friend big_integer operator^(big_integer const &a, big_integer &&b);
+
+    friend big_integer operator^(big_integer &&a, big_integer &&b);
+
     friend big_integer operator<<(big_integer const &a, int b);
 
+    friend big_integer operator<<(big_integer &&a, int b);
+
     friend big_integer operator>>(big_integer const &a, int b);
 
+    friend big_integer operator>>(big_integer &&a, int b);
+
     friend bool operator==(big_integer const &a, big_integer const &b);
 
     friend bool operator!=(big_integer const &a, big_integer const &b);
@@ -113,24 +237,201 @@ struct big_integer {
 
     friend std::ostream &operator<<(std::ostream &s, big_integer const &a);
 
-    uint32_t return_value(size_t index) const {
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator+(big_integer const &a, T b) {
+        big_integer answer = a;
+        answer += b;
+        return answer;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator+(big_integer &&a, T b) {
+        a += b;
+        return std::move(a);
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator+(T a, big_integer const &b) {
+        return b + a;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator+(T a, big_integer &&b) {
+        return std::move(b) + a;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator-(big_integer const &a, T b) {
+        big_integer answer = a;
+        answer -= b;
+        return answer;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator-(big_integer &&a, T b) {
+        a -= b;
+        return std::move(a);
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator-(T a, big_integer const &b) {
+        big_integer answer = -b;
+        answer += a;
+        return answer;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator-(T a, big_integer &&b) {
+        big_integer answer = -std::move(b);
+        answer += a;
+        return answer;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator*(big_integer const &a, T b) {
+        big_integer answer = a;
+        answer *= b;
+        return answer;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator*(big_integer &&a, T b) {
+        a *= b;
+        return std::move(a);
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator*(T a, big_integer const &b) {
+        return b * a;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator*(T a, big_integer &&b) {
+        return std::move(b) * a;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator/(big_integer const &a, T b) {
+        big_integer answer = a;
+        answer /= b;
+        return answer;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator/(big_integer &&a, T b) {
+        a /= b;
+        return std::move(a);
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend void addmul(big_integer &to, big_integer const &a, T b) {
+        to.add_native_product(a, native_magnitude(Native(b)), native_negative(Native(b)));
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend void submul(big_integer &to, big_integer const &a, T b) {
+        to.add_native_product(a, native_magnitude(Native(b)), !native_negative(Native(b)));
+    }
+
+    // the remainder is at most a native magnitude, so a is only read
+    template<typename T, typename Native = native_integer<T>>
+    friend big_integer operator%(big_integer const &a, T b) {
+        big_integer answer;
+        answer.assign_native(a.mod_native(native_magnitude(Native(b))), a.sign);
+        return answer;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend int compare(big_integer const &a, T b) {
+        return a.compare_native(native_magnitude(Native(b)), native_negative(Native(b)));
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend int compare(T a, big_integer const &b) {
+        return -compare(b, a);
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend bool operator==(big_integer const &a, T b) {
+        return compare(a, b) == 0;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend bool operator==(T a, big_integer const &b) {
+        return compare(b, a) == 0;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend bool operator!=(big_integer const &a, T b) {
+        return compare(a, b) != 0;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend bool operator!=(T a, big_integer const &b) {
+        return compare(b, a) != 0;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend bool operator<(big_integer const &a, T b) {
+        return compare(a, b) < 0;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend bool operator<(T a, big_integer const &b) {
+        return compare(b, a) > 0;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend bool operator>(big_integer const &a, T b) {
+        return compare(a, b) > 0;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend bool operator>(T a, big_integer const &b) {
+        return compare(b, a) < 0;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend bool operator<=(big_integer const &a, T b) {
+        return compare(a, b) <= 0;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend bool operator<=(T a, big_integer const &b) {
+        return compare(b, a) >= 0;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend bool operator>=(big_integer const &a, T b) {
+        return compare(a, b) >= 0;
+    }
+
+    template<typename T, typename Native = native_integer<T>>
+    friend bool operator>=(T a, big_integer const &b) {
+        return compare(b, a) <= 0;
+    }
+
+    limb_t return_value(size_t index) const {
         return size() > index ? (*this)[index] : 0;
     }
 private:
 
-    using function = std::function<unsigned int(uint32_t, uint32_t)>;
+    friend struct montgomery_context;
 
-    friend big_integer bit_operation(big_integer const &a, big_integer const &b, const big_integer::function &function);
+    friend struct modulus;
 
-    friend big_integer short_div(big_integer const &first, uint32_t second);
+    friend struct gcd_matrix;
 
-    unsigned int &operator[](size_t index) {
+    template<typename Operation>
+    friend void bit_operation(big_integer &answer, big_integer const &a, big_integer const &b, Operation operation);
+
+    limb_t &operator[](size_t index) {
         return bits[index];
     }
 
-    unsigned int operator[](size_t index) const {
+    limb_t operator[](size_t index) const {
         if (index >= size()) {
-            uint32_t null = 0;
+            limb_t null = 0;
             return null;
         }
         return bits[index];
@@ -149,36 +450,80 @@ private:
         }
     }
 
-    void push_back(uint32_t element) {
+    void push_back(limb_t element) {
         bits.push_back(element);
     }
 
-    friend bool smaller(big_integer const &first, big_integer const &second, size_t index);
+    friend void divide(big_integer const &a, big_integer const &b, big_integer &quotient, big_integer &remainder);
+
+    friend void divide_newton(limb_t *quotient, limb_t *numerator, size_t length,
+                              limb_t const *divisor, size_t divisor_length);
 
-    friend void decrease(big_integer &first, big_integer const &second, size_t index);
+    friend void from_decimal(big_integer &value, char const *digits, size_t length);
 
-    friend big_integer increase(big_integer const &first, uint32_t second);
+    friend void from_decimal(big_integer &value, char const *digits, size_t length,
+                             std::vector<big_integer> const &powers);
 
-    void reverse() {
-        std::reverse(bits.begin(), bits.end());
+    friend void to_decimal(std::string &answer, big_integer const &value, size_t width,
+                           std::vector<big_integer> const &powers);
+
+    friend void divide_exact(big_integer &value, limb_t divisor);
+
+    friend bool lehmer_step(big_integer const &a, big_integer const &b, big_integer &first, big_integer &second,
+                            int64_t (&cofactors)[4]);
+
+    friend void gcd_reduce(big_integer &a, big_integer &b, big_integer *cofactor, big_integer *next_cofactor);
+
+    friend void sqrt_rem(big_integer const &value, big_integer &root, big_integer &rest);
+
+    friend big_integer root_floor(big_integer const &value, uint64_t k);
+
+    friend void add_multiple(big_integer &to, big_integer const &value, limb_t factor, bool subtract);
+
+    friend void toom_cook(limb_t *answer, limb_t const *first, size_t first_length,
+                          limb_t const *second, size_t second_length, size_t parts);
+
+    void mul_limb(limb_t factor);
+
+    static uint64_t native_magnitude(int64_t value) {
+        return value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
     }
 
-    friend big_integer additional(big_integer const &a) {
-        if (a.sign) {
-            big_integer change;
-            for (size_t i = 0; i < a.size(); i++) {
-                change.push_back(~a[i]);
-            }
-            change++;
-            change.sign = true;
-            return change;
-        } else {
-            return a;
-        }
+    static uint64_t native_magnitude(uint64_t value) {
+        return value;
     }
 
+    static bool native_negative(int64_t value) {
+        return value < 0;
+    }
+
+    static bool native_negative(uint64_t) {
+        return false;
+    }
+
+    void assign_native(uint64_t magnitude, bool negative);
+
+    void add_native(uint64_t magnitude, bool negative);
+
+    void mul_native(uint64_t magnitude, bool negative);
+
+    void div_native(uint64_t magnitude, bool negative);
+
+    uint64_t mod_native(uint64_t magnitude) const;
+
+    int compare_native(uint64_t magnitude, bool negative) const;
+
+    void add_product(limb_t const *first, size_t first_length, limb_t const *second, size_t second_length,
+                     bool negative);
+
+    void add_native_product(big_integer const &value, uint64_t magnitude, bool negative);
+
+    void shift_left(size_t shift);
+
+    bool shift_right(size_t shift);
+
     void allocate(size_t new_size) {
-        bits = std::vector<uint32_t>(new_size, 0);
+        bits = std::vector<limb_t>(new_size, 0);
         sign = false;
     }
 
@@ -187,9 +532,96 @@ private:
     }
 
 private:
-    std::vector<uint32_t> bits;
+    std::vector<limb_t> bits;
 
     bool sign;
 };
 
+// declared at namespace scope as well, so that native arguments convert
+big_integer powmod(big_integer const &base, big_integer const &exponent, big_integer const &modulus);
+
+big_integer pow(big_integer const &base, uint64_t exponent);
+
+big_integer gcd(big_integer const &a, big_integer const &b);
+
+big_integer lcm(big_integer const &a, big_integer const &b);
+
+big_integer gcdext(big_integer const &a, big_integer const &b, big_integer &x, big_integer &y);
+
+big_integer invert(big_integer const &a, big_integer const &modulus);
+
+big_integer isqrt(big_integer const &value);
+
+big_integer iroot(big_integer const &value, uint64_t k);
+
+// n!, n choose k (0 for k > n) and the product of the primes up to n, by balanced product trees
+big_integer factorial(uint64_t n);
+
+big_integer binomial(uint64_t n, uint64_t k);
+
+big_integer primorial(uint64_t n);
+
+// Montgomery arithmetic modulo an odd modulus m with R = B^n, where B is the limb base and n is the length of m:
+// numbers in Montgomery form x R mod m are multiplied without division, so that a chain of products
+// (as in powmod) only converts into and out of the form once
+struct montgomery_context {
+    explicit montgomery_context(big_integer const &modulus);
+
+    big_integer to_montgomery(big_integer const &value) const;
+
+    big_integer from_montgomery(big_integer const &value) const;
+
+    // a * b / R mod m for a, b in Montgomery form; operands outside of [0, m) are reduced first
+    big_integer multiply(big_integer const &a, big_integer const &b) const;
+
+    big_integer square(big_integer const &a) const;
+
+    // base^exponent mod m for ordinary base and exponent >= 0, by sliding windows
+    big_integer pow(big_integer const &base, big_integer const &exponent) const;
+
+private:
+    std::vector<limb_t> padded(big_integer const &value) const;
+
+    void reduce(limb_t *answer, limb_t *product) const;
+
+    void multiply(limb_t *answer, limb_t const *a, limb_t const *b, limb_t *scratch) const;
+
+    big_integer divisor;
+
+    size_t length;
+
+    // -m^(-1) mod B
+    limb_t inverse;
+
+    std::vector<limb_t> r_squared;
+};
+
+// Barrett reduction modulo a fixed m > 0 of n limbs: floor(B^(2n) / m) is computed once, after that
+// every reduction takes two multiplications instead of a division; unlike montgomery_context, m may be even
+struct modulus {
+    explicit modulus(big_integer const &value);
+
+    // value mod m in [0, m) for any value
+    big_integer reduce(big_integer const &value) const;
+
+    // the results are in [0, m), operands outside of [0, m) are reduced first
+    big_integer mulmod(big_integer const &a, big_integer const &b) const;
+
+    big_integer addmod(big_integer const &a, big_integer const &b) const;
+
+    big_integer submod(big_integer const &a, big_integer const &b) const;
+
+private:
+    bool is_reduced(big_integer const &value) const;
+
+    void reduce(limb_t *answer, limb_t const *number, limb_t *scratch) const;
+
+    big_integer divisor;
+
+    size_t length;
+
+    // floor(B^(2n) / m) in n + 1 limbs
+    std::vector<limb_t> inverse;
+};
+
 #endif // BIG_INTEGER_H
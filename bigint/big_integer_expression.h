@@ -0,0 +1,157 @@
+#ifndef BIG_INTEGER_EXPRESSION_H
+#define BIG_INTEGER_EXPRESSION_H
+
+#include "big_integer.h"
+
+// An optional expression-template layer over big_integer. Operands wrapped by lazy() build a tree
+// instead of temporaries, and converting the tree to big_integer evaluates it into the one result:
+// products are accumulated into it by addmul and submul, sums and differences are added in place,
+// so lazy(a) * b + c, lazy(a) * b - lazy(c) * d and (lazy(a) + b) % m need no intermediate big_integer.
+// A tree keeps references to its operands and is meant to be converted within the same full expression.
+
+template<typename Expression>
+struct lazy_expression {
+    operator big_integer() const {
+        big_integer result;
+        static_cast<Expression const &>(*this).accumulate(result, false);
+        return result;
+    }
+};
+
+struct lazy_value : lazy_expression<lazy_value> {
+    explicit lazy_value(big_integer const &value) : value(value) {}
+
+    // to += value, or to -= value if subtract
+    void accumulate(big_integer &to, bool subtract) const {
+        if (subtract) {
+            to -= value;
+        } else {
+            to += value;
+        }
+    }
+
+    big_integer const &value;
+};
+
+inline lazy_value lazy(big_integer const &value) {
+    return lazy_value(value);
+}
+
+// factors of a product are big_integer themselves, other subexpressions are evaluated into storage
+inline big_integer const &lazy_factor(lazy_value const &factor, big_integer &) {
+    return factor.value;
+}
+
+template<typename Expression>
+big_integer const &lazy_factor(lazy_expression<Expression> const &factor, big_integer &storage) {
+    storage = factor;
+    return storage;
+}
+
+template<typename Left, typename Right>
+struct lazy_product : lazy_expression<lazy_product<Left, Right>> {
+    lazy_product(Left const &left, Right const &right) : left(left), right(right) {}
+
+    void accumulate(big_integer &to, bool subtract) const {
+        big_integer left_storage, right_storage;
+        big_integer const &first = lazy_factor(left, left_storage), &second = lazy_factor(right, right_storage);
+        if (subtract) {
+            submul(to, first, second);
+        } else {
+            addmul(to, first, second);
+        }
+    }
+
+    Left left;
+    Right right;
+};
+
+// left + right, or left - right if subtract
+template<typename Left, typename Right>
+struct lazy_sum : lazy_expression<lazy_sum<Left, Right>> {
+    lazy_sum(Left const &left, Right const &right, bool subtract) : left(left), right(right), subtract(subtract) {}
+
+    void accumulate(big_integer &to, bool negate) const {
+        left.accumulate(to, negate);
+        right.accumulate(to, negate ^ subtract);
+    }
+
+    Left left;
+    Right right;
+    bool subtract;
+};
+
+template<typename Dividend>
+struct lazy_remainder : lazy_expression<lazy_remainder<Dividend>> {
+    lazy_remainder(Dividend const &dividend, big_integer const &modulus) : dividend(dividend), modulus(modulus) {}
+
+    // the dividend is reduced in the destination itself when that starts at zero
+    void accumulate(big_integer &to, bool subtract) const {
+        if (to == 0 && !subtract) {
+            dividend.accumulate(to, false);
+            to %= modulus;
+        } else {
+            big_integer rest = *this;
+            lazy_value(rest).accumulate(to, subtract);
+        }
+    }
+
+    Dividend dividend;
+    big_integer const &modulus;
+};
+
+// a big_integer operand of either value category, so that the rvalue overloads of big_integer do not compete
+template<typename T>
+using big_integer_operand = typename std::enable_if<std::is_same<typename std::decay<T>::type, big_integer>::value>::type;
+
+template<typename Left, typename Right>
+lazy_product<Left, Right> operator*(lazy_expression<Left> const &left, lazy_expression<Right> const &right) {
+    return {static_cast<Left const &>(left), static_cast<Right const &>(right)};
+}
+
+template<typename Left, typename Right, typename = big_integer_operand<Right>>
+lazy_product<Left, lazy_value> operator*(lazy_expression<Left> const &left, Right &&right) {
+    return {static_cast<Left const &>(left), lazy_value(right)};
+}
+
+template<typename Left, typename Right, typename = big_integer_operand<Left>>
+lazy_product<lazy_value, Right> operator*(Left &&left, lazy_expression<Right> const &right) {
+    return {lazy_value(left), static_cast<Right const &>(right)};
+}
+
+template<typename Left, typename Right>
+lazy_sum<Left, Right> operator+(lazy_expression<Left> const &left, lazy_expression<Right> const &right) {
+    return {static_cast<Left const &>(left), static_cast<Right const &>(right), false};
+}
+
+template<typename Left, typename Right, typename = big_integer_operand<Right>>
+lazy_sum<Left, lazy_value> operator+(lazy_expression<Left> const &left, Right &&right) {
+    return {static_cast<Left const &>(left), lazy_value(right), false};
+}
+
+template<typename Left, typename Right, typename = big_integer_operand<Left>>
+lazy_sum<lazy_value, Right> operator+(Left &&left, lazy_expression<Right> const &right) {
+    return {lazy_value(left), static_cast<Right const &>(right), false};
+}
+
+template<typename Left, typename Right>
+lazy_sum<Left, Right> operator-(lazy_expression<Left> const &left, lazy_expression<Right> const &right) {
+    return {static_cast<Left const &>(left), static_cast<Right const &>(right), true};
+}
+
+template<typename Left, typename Right, typename = big_integer_operand<Right>>
+lazy_sum<Left, lazy_value> operator-(lazy_expression<Left> const &left, Right &&right) {
+    return {static_cast<Left const &>(left), lazy_value(right), true};
+}
+
+template<typename Left, typename Right, typename = big_integer_operand<Left>>
+lazy_sum<lazy_value, Right> operator-(Left &&left, lazy_expression<Right> const &right) {
+    return {lazy_value(left), static_cast<Right const &>(right), true};
+}
+
+template<typename Dividend, typename Modulus, typename = big_integer_operand<Modulus>>
+lazy_remainder<Dividend> operator%(lazy_expression<Dividend> const &dividend, Modulus &&modulus) {
+    return {static_cast<Dividend const &>(dividend), modulus};
+}
+
+#endif // BIG_INTEGER_EXPRESSION_H
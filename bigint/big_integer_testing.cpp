@@ -7,6 +7,7 @@
 #include <gtest/gtest.h>
 
 #include "big_integer.h"
+#include "big_integer_expression.h"
 #include "big_integer_gmp.h"
 
 TEST(correctness, two_plus_two) {
@@ -100,6 +101,80 @@ TEST(correctness, compare_zero_and_minus_zero) {
     EXPECT_TRUE(a == b);
 }
 
+TEST(correctness, three_way_compare) {
+    big_integer a("-100000000000000000000000000000");
+    big_integer b("-99999999999999999999999999999");
+    big_integer c("99999999999999999999999999999");
+    std::vector<big_integer> sorted = {a, b, -1, 0, 1, c, -a};
+
+    for (size_t i = 0; i < sorted.size(); i++) {
+        for (size_t j = 0; j < sorted.size(); j++) {
+            int expected = i < j ? -1 : (i == j ? 0 : 1);
+            EXPECT_EQ(expected, compare(sorted[i], sorted[j]));
+            EXPECT_EQ(i < j, sorted[i] < sorted[j]);
+            EXPECT_EQ(i <= j, sorted[i] <= sorted[j]);
+            EXPECT_EQ(i > j, sorted[i] > sorted[j]);
+            EXPECT_EQ(i >= j, sorted[i] >= sorted[j]);
+            EXPECT_EQ(i == j, sorted[i] == sorted[j]);
+            EXPECT_EQ(i != j, sorted[i] != sorted[j]);
+        }
+    }
+}
+
+// every operation with the native n must agree with the same operation with b = n
+template<typename T>
+static void check_native(big_integer const &a, big_integer const &b, T n) {
+    EXPECT_EQ(a + b, a + n);
+    EXPECT_EQ(b + a, n + a);
+    EXPECT_EQ(a - b, a - n);
+    EXPECT_EQ(b - a, n - a);
+    EXPECT_EQ(a * b, a * n);
+    EXPECT_EQ(b * a, n * a);
+    EXPECT_EQ(compare(a, b), compare(a, n));
+    EXPECT_EQ(compare(b, a), compare(n, a));
+    EXPECT_EQ(a == b, a == n);
+    EXPECT_EQ(a != b, n != a);
+    EXPECT_EQ(a < b, a < n);
+    EXPECT_EQ(b < a, n < a);
+    EXPECT_EQ(a >= b, a >= n);
+    EXPECT_EQ(b >= a, n >= a);
+    if (n != 0) {
+        EXPECT_EQ(a / b, a / n);
+        EXPECT_EQ(a % b, a % n);
+        big_integer c = a;
+        c %= n;
+        EXPECT_EQ(a % b, c);
+    }
+    big_integer c = a;
+    c += n;
+    c *= n;
+    c -= n;
+    EXPECT_EQ((a + b) * b - b, c);
+}
+
+TEST(correctness, native_operands) {
+    big_integer power = big_integer(1) << 64;
+    std::vector<big_integer> values = {0, 1, -1, 7, -7, (big_integer(1) << 32) + 1, -(big_integer(1) << 32),
+                                       power - 1, -power + 1, power, -power,
+                                       big_integer("-123456789012345678901234567890123456789")};
+    std::vector<int64_t> signed_natives = {0, 1, -1, 7, -10, 1000000000, INT64_C(4294967296), -INT64_C(4294967297),
+                                           std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()};
+    std::vector<uint64_t> unsigned_natives = {0, 1, 10, UINT64_C(4294967295), UINT64_C(4294967296),
+                                              std::numeric_limits<uint64_t>::max()};
+    for (big_integer const &a : values) {
+        for (int64_t n : signed_natives) {
+            check_native(a, big_integer(std::to_string(n)), n);
+        }
+        for (uint64_t n : unsigned_natives) {
+            check_native(a, big_integer(std::to_string(n)), n);
+        }
+        check_native(a, big_integer(-3), static_cast<short>(-3));
+        check_native(a, big_integer(200), static_cast<unsigned char>(200));
+    }
+    EXPECT_THROW(big_integer(5) / 0, std::runtime_error);
+    EXPECT_THROW(big_integer(5) % UINT64_C(0), std::runtime_error);
+}
+
 TEST(correctness, add) {
     big_integer a = 5;
     big_integer b = 20;
@@ -127,6 +202,393 @@ TEST(correctness, add_return_value) {
     EXPECT_EQ(7, a);
 }
 
+TEST(correctness, compound_assignment_long) {
+    big_integer a("-123456789012345678901234567890123456789");
+    big_integer b("98765432109876543210987654321");
+    big_integer c = a;
+
+    c += b;
+    EXPECT_EQ(a + b, c);
+    c -= a;
+    EXPECT_EQ(b, c);
+    c -= a;
+    EXPECT_EQ(b - a, c);
+    c += a;
+    c += a;
+    EXPECT_EQ(b + a, c);
+    c *= -7;
+    EXPECT_EQ((a + b) * -7, c);
+    c *= b;
+    EXPECT_EQ((a + b) * -7 * b, c);
+    c <<= 77;
+    EXPECT_EQ((a + b) * -7 * b * (big_integer(1) << 77), c);
+    c = -c;
+    c >>= 77;
+    EXPECT_EQ(-(a + b) * -7 * b, c);
+    c &= b;
+    EXPECT_EQ((-(a + b) * -7 * b) & b, c);
+    c |= a;
+    EXPECT_EQ(((-(a + b) * -7 * b) & b) | a, c);
+    c = abs(a);
+    c ^= b;
+    EXPECT_EQ(abs(a) ^ b, c);
+    c |= b;
+    EXPECT_EQ((abs(a) ^ b) | b, c);
+    c <<= 0;
+    c >>= 0;
+    EXPECT_EQ((abs(a) ^ b) | b, c);
+    EXPECT_EQ(a, a << 0);
+    EXPECT_EQ(a, a >> 0);
+}
+
+TEST(correctness, compound_assignment_self) {
+    big_integer a("-123456789012345678901234567890123456789");
+    big_integer b = a;
+
+    b += b;
+    EXPECT_EQ(a * 2, b);
+    b -= b;
+    EXPECT_EQ(0, b);
+    b = 5;
+    b *= b;
+    EXPECT_EQ(25, b);
+    b = a;
+    b *= b;
+    EXPECT_EQ(a * a, b);
+    b = -a;
+    b &= b;
+    EXPECT_EQ(-a, b);
+    b ^= b;
+    EXPECT_EQ(0, b);
+}
+
+TEST(correctness, move_semantics) {
+    big_integer a("-123456789012345678901234567890123456789");
+    big_integer b("98765432109876543210987654321");
+    big_integer c = a;
+
+    big_integer moved(std::move(c));
+    EXPECT_EQ(a, moved);
+    EXPECT_EQ(0, c);
+    c = std::move(moved);
+    EXPECT_EQ(a, c);
+    EXPECT_EQ(0, moved);
+    c = std::move(c);
+    EXPECT_EQ(a, c);
+
+    // every combination of expiring and kept operands gives the same result
+    EXPECT_EQ(a + b, big_integer(a) + b);
+    EXPECT_EQ(a + b, a + big_integer(b));
+    EXPECT_EQ(a + b, big_integer(a) + big_integer(b));
+    EXPECT_EQ(a - b, big_integer(a) - b);
+    EXPECT_EQ(a - b, a - big_integer(b));
+    EXPECT_EQ(a - b, big_integer(a) - big_integer(b));
+    EXPECT_EQ(a & b, big_integer(a) & b);
+    EXPECT_EQ(a | b, a | big_integer(b));
+    EXPECT_EQ(a ^ b, big_integer(a) ^ big_integer(b));
+    EXPECT_EQ(a << 100, big_integer(a) << 100);
+    EXPECT_EQ(a >> 100, big_integer(a) >> 100);
+    EXPECT_EQ(a * 10 + 1, big_integer(a) * 10 + 1);
+    EXPECT_EQ(7 - a, 7 - big_integer(a));
+    EXPECT_EQ(-a, -big_integer(a));
+    EXPECT_EQ(~a, ~big_integer(a));
+    EXPECT_EQ(a + b + a + b, (a + b) + (a + b));
+
+    c = a;
+    c = std::move(c) + c;
+    EXPECT_EQ(a * 2, c);
+    c = a;
+    c = c - std::move(c);
+    EXPECT_EQ(0, c);
+}
+
+TEST(correctness, addmul_submul) {
+    big_integer a("-123456789012345678901234567890123456789");
+    big_integer b("98765432109876543210987654321");
+    big_integer c("5555555555555555555555555555555555555555555555555");
+    std::vector<big_integer> accumulators = {0, 1, -1, c, -c, a * b, -(a * b), a * b + 1};
+
+    for (big_integer const &start : accumulators) {
+        big_integer to = start;
+        addmul(to, a, b);
+        EXPECT_EQ(start + a * b, to);
+        to = start;
+        submul(to, a, b);
+        EXPECT_EQ(start - a * b, to);
+        to = start;
+        addmul(to, a, -7);
+        EXPECT_EQ(start + a * -7, to);
+        to = start;
+        submul(to, b, std::numeric_limits<uint64_t>::max());
+        EXPECT_EQ(start - b * big_integer("18446744073709551615"), to);
+        to = start;
+        addmul(to, a, 0);
+        EXPECT_EQ(start, to);
+    }
+
+    big_integer to = a;
+    addmul(to, to, to);
+    EXPECT_EQ(a + a * a, to);
+    to = a;
+    submul(to, to, b);
+    EXPECT_EQ(a - a * b, to);
+    to = a;
+    addmul(to, to, 3);
+    EXPECT_EQ(a * 4, to);
+}
+
+// base^exponent mod modulus by binary powering with * and %
+static big_integer naive_powmod(big_integer base, big_integer exponent, big_integer const &modulus) {
+    big_integer answer = 1 % modulus;
+    base %= modulus;
+    if (base < 0) {
+        base += modulus;
+    }
+    for (; exponent > 0; exponent >>= 1) {
+        if ((exponent & 1) == 1) {
+            answer = answer * base % modulus;
+        }
+        base = base * base % modulus;
+    }
+    return answer;
+}
+
+TEST(correctness, powmod) {
+    EXPECT_EQ(1, powmod(2, 0, 7));
+    EXPECT_EQ(0, powmod(2, 0, 1));
+    EXPECT_EQ(0, powmod(5, 3, 1));
+    EXPECT_EQ(6, powmod(-1, 1, 7));
+    EXPECT_EQ(1, powmod(-1, 2, 8));
+    EXPECT_EQ(4, powmod(2, 10, 12));
+    EXPECT_THROW(powmod(2, -1, 7), std::runtime_error);
+    EXPECT_THROW(powmod(2, 3, 0), std::runtime_error);
+    EXPECT_THROW(powmod(2, 3, -7), std::runtime_error);
+    EXPECT_THROW(montgomery_context(big_integer(10)), std::runtime_error);
+
+    // Fermat's little theorem for the Mersenne primes 2^127 - 1 and 2^521 - 1
+    for (int p : {127, 521}) {
+        big_integer prime = (big_integer(1) << p) - 1;
+        EXPECT_EQ(1, powmod(3, prime - 1, prime));
+        EXPECT_EQ(big_integer("123456789123456789"), powmod(big_integer("123456789123456789"), prime, prime));
+    }
+
+    big_integer modulus("1000000000000000000000000000000000000000000000000000000000000000000000007");
+    big_integer base("-98765432109876543210987654321098765432109876543210");
+    big_integer exponent("12345678901234567890123456789");
+    EXPECT_EQ(naive_powmod(base, exponent, modulus), powmod(base, exponent, modulus));
+    EXPECT_EQ(naive_powmod(base, exponent, modulus * 2), powmod(base, exponent, modulus * 2));
+
+    montgomery_context context(modulus);
+    big_integer a = context.to_montgomery(base), b = context.to_montgomery(exponent);
+    EXPECT_EQ((base * exponent % modulus + modulus) % modulus, context.from_montgomery(context.multiply(a, b)));
+    EXPECT_EQ(base * base % modulus, context.from_montgomery(context.square(a)));
+
+    // operands at or above the modulus and negative ones are reduced
+    big_integer cube = modulus * modulus * modulus;
+    EXPECT_EQ(context.multiply(a, b), context.multiply(a + modulus * 5, b - modulus));
+    EXPECT_EQ(context.multiply(a, b), context.multiply(a - cube, b + cube));
+    EXPECT_EQ(context.square(a), context.square(a - modulus));
+    EXPECT_EQ(context.from_montgomery(a), context.from_montgomery(a + cube));
+    EXPECT_EQ(context.from_montgomery(a), context.from_montgomery(a - modulus * 7));
+    EXPECT_EQ(0, context.from_montgomery(modulus));
+}
+
+TEST(correctness, barrett_modulus) {
+    EXPECT_THROW(modulus(big_integer(0)), std::runtime_error);
+    EXPECT_THROW(modulus(big_integer(-5)), std::runtime_error);
+
+    modulus one(1);
+    EXPECT_EQ(0, one.reduce(big_integer("123456789012345678901234567890")));
+    EXPECT_EQ(0, one.mulmod(7, 9));
+
+    modulus ten(10);
+    EXPECT_EQ(3, ten.reduce(-7));
+    EXPECT_EQ(0, ten.reduce(-10));
+    EXPECT_EQ(3, ten.mulmod(7, 9));
+    EXPECT_EQ(6, ten.mulmod(-7, 2));
+    EXPECT_EQ(1, ten.addmod(7, 4));
+    EXPECT_EQ(3, ten.addmod(-8, 1));
+    EXPECT_EQ(7, ten.submod(1, 4));
+    EXPECT_EQ(2, ten.submod(25, 3));
+
+    // powers of the limb base have the largest reciprocal
+    for (int shift : {32, 64, 128}) {
+        big_integer power = big_integer(1) << shift;
+        modulus m(power);
+        big_integer value("-340282366920938463463374607431768211455123456789");
+        big_integer expected = value % power;
+        if (expected < 0) {
+            expected += power;
+        }
+        EXPECT_EQ(expected, m.reduce(value));
+        EXPECT_EQ((power - 1) * (power - 1) % power, m.mulmod(power - 1, power - 1));
+    }
+}
+
+TEST(correctness, pow) {
+    EXPECT_EQ(1, pow(big_integer(0), 0));
+    EXPECT_EQ(0, pow(big_integer(0), 5));
+    EXPECT_EQ(1, pow(big_integer(7), 0));
+    EXPECT_EQ(-1, pow(big_integer(-1), 12345678901ull));
+    EXPECT_EQ(1, pow(big_integer(1), 12345678901ull));
+    EXPECT_EQ(-27, pow(big_integer(-3), 3));
+    EXPECT_EQ(-8, pow(big_integer(-2), 3));
+    EXPECT_EQ(big_integer(1) << 100, pow(big_integer(2), 100));
+    EXPECT_EQ(big_integer(1) << 300, pow(big_integer(1) << 60, 5));
+    EXPECT_EQ(big_integer("1000000000000000000000000000000"), pow(big_integer(10), 30));
+
+    big_integer a("-1104427674243920646305299201");
+    EXPECT_EQ(a * a, pow(a, 2));
+    EXPECT_EQ(a * a * a * 1000, pow(a * 10, 3));
+}
+
+// gcd(a, b) by Euclid's algorithm with %
+static big_integer naive_gcd(big_integer a, big_integer b) {
+    a = abs(a);
+    b = abs(b);
+    while (b != 0) {
+        a %= b;
+        swap(a, b);
+    }
+    return a;
+}
+
+TEST(correctness, gcd) {
+    EXPECT_EQ(0, gcd(0, 0));
+    EXPECT_EQ(5, gcd(0, -5));
+    EXPECT_EQ(6, gcd(-12, 18));
+    EXPECT_EQ(1, gcd(17, 5));
+    EXPECT_EQ(0, lcm(0, 7));
+    EXPECT_EQ(36, lcm(-12, 18));
+
+    big_integer x, y;
+    EXPECT_EQ(6, gcdext(-12, 18, x, y));
+    EXPECT_EQ(6, -12 * x + 18 * y);
+    EXPECT_EQ(7, gcdext(0, -7, x, y));
+    EXPECT_EQ(7, -7 * y);
+
+    EXPECT_EQ(4, invert(3, 11));
+    EXPECT_EQ(7, invert(-3, 11));
+    EXPECT_EQ(0, invert(5, 1));
+    EXPECT_THROW(invert(4, 10), std::runtime_error);
+    EXPECT_THROW(invert(3, 0), std::runtime_error);
+
+    // consecutive Fibonacci numbers are coprime and take the most Euclid's steps
+    big_integer previous = 0, current = 1;
+    for (int i = 0; i < 1000; i++) {
+        previous += current;
+        swap(previous, current);
+    }
+    EXPECT_EQ(1, gcd(current, previous));
+    EXPECT_EQ(1, gcdext(current, previous, x, y));
+    EXPECT_EQ(1, current * x + previous * y);
+    EXPECT_EQ(1, invert(previous, current) * previous % current);
+
+    big_integer common("123456789012345678901234567890123456789");
+    big_integer a = common * big_integer("98765432109876543210987654321"), b = common * 1000003;
+    EXPECT_EQ(naive_gcd(a, b), gcd(a, b));
+    EXPECT_EQ(a / gcd(a, b) * b, lcm(a, b));
+}
+
+TEST(correctness, roots) {
+    EXPECT_EQ(0, isqrt(0));
+    EXPECT_EQ(1, isqrt(3));
+    EXPECT_EQ(2, isqrt(4));
+    EXPECT_EQ(65535, isqrt(big_integer("4294967295")));
+    EXPECT_EQ(65536, isqrt(big_integer("4294967296")));
+    EXPECT_THROW(isqrt(-1), std::runtime_error);
+
+    EXPECT_EQ(-7, iroot(-7, 1));
+    EXPECT_EQ(3, iroot(27, 3));
+    EXPECT_EQ(2, iroot(26, 3));
+    EXPECT_EQ(-3, iroot(-27, 3));
+    EXPECT_EQ(1, iroot(1000, 100));
+    EXPECT_THROW(iroot(-16, 4), std::runtime_error);
+    EXPECT_THROW(iroot(16, 0), std::runtime_error);
+
+    big_integer ten("10000000000000000000000000000000000000000");
+    EXPECT_EQ(big_integer("100000000000000000000"), isqrt(ten));
+    EXPECT_EQ(big_integer("99999999999999999999"), isqrt(ten - 1));
+    EXPECT_EQ(big_integer("10000000000"), iroot(ten, 4));
+    EXPECT_EQ(big_integer("9999999999"), iroot(ten - 1, 4));
+    EXPECT_EQ(big_integer("21544346900318"), iroot(ten, 3));
+}
+
+TEST(correctness, combinatorics) {
+    EXPECT_EQ(1, factorial(0));
+    EXPECT_EQ(1, factorial(1));
+    EXPECT_EQ(120, factorial(5));
+    EXPECT_EQ(big_integer("2432902008176640000"), factorial(20));
+    EXPECT_EQ(big_integer("15511210043330985984000000"), factorial(25));
+
+    EXPECT_EQ(0, binomial(3, 4));
+    EXPECT_EQ(1, binomial(0, 0));
+    EXPECT_EQ(1, binomial(7, 7));
+    EXPECT_EQ(35, binomial(7, 3));
+    EXPECT_EQ(big_integer("100891344545564193334812497256"), binomial(100, 50));
+    EXPECT_EQ(big_integer("166666666666666666166666666666666667000000000000000000"), binomial(1000000000000000000ull, 3));
+
+    EXPECT_EQ(1, primorial(0));
+    EXPECT_EQ(1, primorial(1));
+    EXPECT_EQ(2, primorial(2));
+    EXPECT_EQ(big_integer("6469693230"), primorial(30));
+    EXPECT_EQ(big_integer("200560490130"), primorial(36));
+}
+
+TEST(correctness, expression_templates) {
+    big_integer a("-123456789012345678901234567890123456789");
+    big_integer b("98765432109876543210987654321");
+    big_integer c("-5555555555555555555555555555555555555555555555555");
+    big_integer d = 7;
+
+    EXPECT_EQ(a * b + c, big_integer(lazy(a) * b + c));
+    EXPECT_EQ(c + a * b, big_integer(c + lazy(a) * b));
+    EXPECT_EQ(a * b - c, big_integer(lazy(a) * b - c));
+    EXPECT_EQ(c - a * b, big_integer(c - lazy(a) * b));
+    EXPECT_EQ(a * b - c * d, big_integer(lazy(a) * b - lazy(c) * d));
+    EXPECT_EQ(a * b + c * d, big_integer(lazy(a) * lazy(b) + c * lazy(d)));
+    EXPECT_EQ((a + b) % c, big_integer((lazy(a) + b) % c));
+    EXPECT_EQ((a * b - c) % d, big_integer((lazy(a) * b - c) % d));
+    EXPECT_EQ(c - (a + b) % d, big_integer(c - (lazy(a) + b) % d));
+    EXPECT_EQ((a + b) * (c - d), big_integer((lazy(a) + b) * (lazy(c) - d)));
+    EXPECT_EQ(0, big_integer(lazy(a) * b - lazy(b) * a));
+    EXPECT_EQ(0, big_integer(lazy(a) * b - a * b));
+
+    // sums that carry into the extra top limb
+    big_integer e("4294967295"), f("4294967295"), g("18446744073709551615");
+    big_integer h("340282366920938463463374607431768211455");
+    EXPECT_EQ(big_integer("36893488138829168640"), big_integer(g + lazy(e) * f));
+    EXPECT_EQ(big_integer("36893488138829168640"), big_integer(lazy(g) + lazy(e) * f));
+    EXPECT_EQ(big_integer("340282366920938463481821351496887828480"), big_integer(lazy(h) + lazy(e) * f));
+
+    // Horner's rule with the accumulator on both sides
+    big_integer value = 0, expected = 0;
+    for (int i = 0; i < 20; i++) {
+        value = lazy(value) * c + a;
+        expected = expected * c + a;
+    }
+    EXPECT_EQ(expected, value);
+}
+
+TEST(correctness_random, add_accumulate) {
+    std::default_random_engine rng(322);
+    big_integer sum, expected;
+    for (size_t i = 0; i < 1000; i++) {
+        big_integer term = big_integer(static_cast<int>(rng() % 2000000000)) << static_cast<int>(rng() % 200);
+        if (rng() % 2) {
+            term = -term;
+        }
+        if (rng() % 3) {
+            sum += term;
+            expected = expected + term;
+        } else {
+            sum -= term;
+            expected = expected - term;
+        }
+        EXPECT_EQ(expected, sum);
+    }
+}
+
 TEST(correctness, sub) {
     big_integer a = 20;
     big_integer b = 5;
@@ -241,6 +703,28 @@ TEST(correctness, div_rounding_negative) {
     EXPECT_TRUE(c % d == -3);
 }
 
+TEST(correctness, divmod) {
+    big_integer a = 23;
+    big_integer b = -5;
+
+    auto result = divmod(a, b);
+    EXPECT_EQ(-4, result.first);
+    EXPECT_EQ(3, result.second);
+    result = divmod(-a, b);
+    EXPECT_EQ(4, result.first);
+    EXPECT_EQ(-3, result.second);
+    result = divmod(b, a);
+    EXPECT_EQ(0, result.first);
+    EXPECT_EQ(-5, result.second);
+
+    big_integer c("-1000000000000000000000000000000000000000000000000000000000007");
+    big_integer d("100000000000000000000000000000000000000000000000000000000000");
+    result = divmod(c, d);
+    EXPECT_EQ(-10, result.first);
+    EXPECT_EQ(-7, result.second);
+    EXPECT_THROW(divmod(c, 0), std::runtime_error);
+}
+
 TEST(correctness, div_return_value) {
     big_integer a = 100;
     big_integer b = 2;
@@ -375,6 +859,27 @@ TEST(correctness, xor_return_value) {
     EXPECT_EQ(2, a);
 }
 
+TEST(correctness, bitwise_limb_boundaries) {
+    big_integer power = big_integer(1) << 64;
+    std::vector<big_integer> values = {0, 1, -1, power - 1, power, power + 1, -power + 1, -power, -power - 1,
+                                       (power << 64) - 1, -(power << 64)};
+    for (big_integer const &a : values) {
+        for (big_integer const &b : values) {
+            EXPECT_EQ(a + b, (a & b) + (a | b));
+            EXPECT_EQ((a | b) - (a & b), a ^ b);
+            EXPECT_EQ(~(~a & ~b), a | b);
+            big_integer c = a;
+            c ^= b;
+            EXPECT_EQ(a ^ b, c);
+            c = b;
+            c &= a;
+            EXPECT_EQ(a & b, c);
+        }
+    }
+    EXPECT_EQ(-power, -1 ^ (power - 1));
+    EXPECT_EQ(-power, -power & -power);
+}
+
 TEST(correctness, not_) {
     big_integer a = 0xaa;
     big_integer b = ~a;
@@ -560,6 +1065,23 @@ TEST(correctness, shr_long) {
 
 }
 
+TEST(correctness, shr_negative_rounding) {
+    big_integer power = big_integer(1) << 64;
+    EXPECT_EQ(-2, (-power - 1) >> 64);
+    EXPECT_EQ(-1, -power >> 64);
+    EXPECT_EQ(-power - 1, (-(power << 64) - 1) >> 64);
+    EXPECT_EQ(-power, -(power << 64) >> 64);
+    EXPECT_EQ(-1, big_integer(-1) >> 1000);
+    EXPECT_EQ(-1, (-power) >> 1000);
+    EXPECT_EQ(0, power >> 1000);
+
+    big_integer a = -power - 1;
+    a >>= 32;
+    EXPECT_EQ(-(big_integer(1) << 32) - 1, a);
+    a >>= 0;
+    EXPECT_EQ(-(big_integer(1) << 32) - 1, a);
+}
+
 TEST(correctness, string_conv) {
     EXPECT_EQ("100", to_string(big_integer("100")));
     EXPECT_EQ("100", to_string(big_integer("0100")));
@@ -577,6 +1099,25 @@ TEST(correctness, string_conv) {
     EXPECT_EQ("-2147483649", to_string(lim));
 }
 
+TEST(correctness, string_conv_long) {
+    big_integer power = 1;
+    std::string expected = "1";
+    for (size_t i = 1; i <= 3000; i++) {
+        power *= 10;
+        expected.push_back('0');
+        if (i % 250 == 0 || i % 250 == 9) {
+            EXPECT_EQ(expected, to_string(power));
+            EXPECT_EQ("-" + expected, to_string(-power));
+            EXPECT_EQ(std::string(i, '9'), to_string(power - 1));
+            EXPECT_EQ("1" + std::string(i - 1, '0') + "1", to_string(power + 1));
+            EXPECT_EQ(power, big_integer(expected));
+            EXPECT_EQ(-power, big_integer("-" + expected));
+            EXPECT_EQ(power - 1, big_integer(std::string(i, '9')));
+            EXPECT_EQ(power + 1, big_integer("000" + expected.substr(0, i) + "1"));
+        }
+    }
+}
+
 namespace {
     size_t const number_of_iterations = 10;
     size_t const max_size = 2048;
@@ -744,6 +1285,307 @@ TEST(correctness_random, mul) {
     }
 }
 
+TEST(correctness_random, mul_long_operands) {
+    std::default_random_engine rng(42);
+    size_t const sizes[][2] = {{max_size * 8, max_size * 8},
+                               {max_size * 16, max_size * 3},
+                               {max_size * 5, max_size * 4}};
+    for (auto const &size : sizes) {
+        big_integer_gmp a, b;
+        a.random(size[0], rng);
+        b.random(size[1], rng);
+        big_integer_gmp c = a * b;
+        big_integer R = big_integer(to_string(a)) * big_integer(to_string(b));
+        EXPECT_EQ(to_string(c), to_string(R));
+    }
+}
+
+namespace {
+    // random non-negative number of 30 * size bits, glued from halves to avoid quadratic construction
+    big_integer random_digits(size_t size, std::default_random_engine &rng) {
+        if (size == 1) {
+            return big_integer(static_cast<int>(rng() % (1u << 30u)));
+        }
+        size_t half = size / 2;
+        return (random_digits(size - half, rng) << static_cast<int>(30 * half)) + random_digits(half, rng);
+    }
+}
+
+TEST(correctness_random, expression_long_operands) {
+    std::default_random_engine rng(42);
+    size_t const sizes[][3] = {{max_size * 8, 600, max_size * 4},
+                               {max_size * 3, max_size * 3, max_size * 7},
+                               {max_size * 9, max_size * 2, max_size * 11}};
+    for (auto const &size : sizes) {
+        for (size_t itn = 0; itn != 4; ++itn) {
+            big_integer_gmp a, b, c;
+            a.random(size[0], rng);
+            b.random(size[1], rng);
+            c.random(size[2], rng);
+            big_integer A = big_integer(to_string(a)), B = big_integer(to_string(b)), C = big_integer(to_string(c));
+            EXPECT_EQ(to_string(a * b + c), to_string(big_integer(lazy(A) * B + C)));
+            EXPECT_EQ(to_string(c - a * b), to_string(big_integer(C - lazy(A) * B)));
+            EXPECT_EQ(to_string(a * a - b * c), to_string(big_integer(lazy(A) * A - lazy(B) * C)));
+        }
+    }
+}
+
+TEST(correctness_random, addmul_dot_product) {
+    std::default_random_engine rng(322);
+    size_t const sizes[][2] = {{max_size * 4, 300}, {max_size * 3, max_size * 2}, {max_size * 8, max_size * 6}};
+    for (auto const &size : sizes) {
+        big_integer_gmp expected;
+        big_integer sum;
+        for (size_t itn = 0; itn != 8; ++itn) {
+            big_integer_gmp a, b;
+            a.random(size[0], rng);
+            b.random(size[1], rng);
+            big_integer A = big_integer(to_string(a)), B = big_integer(to_string(b));
+            if (itn % 3 == 2) {
+                expected = expected - a * b;
+                submul(sum, A, B);
+            } else {
+                expected = expected + a * b;
+                addmul(sum, B, A);
+            }
+            EXPECT_EQ(to_string(expected), to_string(sum));
+        }
+    }
+}
+
+TEST(correctness_random, powmod) {
+    std::default_random_engine rng(42);
+    size_t const sizes[] = {64, 700, 2048};
+    for (size_t size : sizes) {
+        big_integer_gmp a, e, m;
+        a.random(size, rng);
+        e.random(size, rng);
+        m.random(size, rng);
+        big_integer base = big_integer(to_string(a)), exponent = abs(big_integer(to_string(e)));
+        big_integer modulus = abs(big_integer(to_string(m))) | 1;
+        EXPECT_EQ(naive_powmod(base, exponent, modulus), powmod(base, exponent, modulus));
+        modulus += 1;
+        EXPECT_EQ(naive_powmod(base, exponent, modulus), powmod(base, exponent, modulus));
+    }
+}
+
+TEST(correctness_random, barrett_modulus) {
+    std::default_random_engine rng(42);
+    size_t const sizes[] = {30, 100, 700, 2048, 9000};
+    for (size_t size : sizes) {
+        big_integer_gmp m;
+        m.random(size, rng);
+        big_integer divisor = abs(big_integer(to_string(m))) + 1;
+        modulus barrett(divisor);
+        for (size_t value_size : {size / 2, size, 2 * size, 5 * size + 17}) {
+            big_integer_gmp a, b;
+            a.random(value_size, rng);
+            b.random(size, rng);
+            big_integer first = big_integer(to_string(a)), second = big_integer(to_string(b));
+            auto reduced = [&divisor](big_integer const &value) {
+                big_integer answer = value % divisor;
+                return answer < 0 ? answer + divisor : answer;
+            };
+            EXPECT_EQ(reduced(first), barrett.reduce(first));
+            EXPECT_EQ(reduced(first * second), barrett.mulmod(first, second));
+            EXPECT_EQ(reduced(first * first), barrett.mulmod(first, first));
+            EXPECT_EQ(reduced(first + second), barrett.addmod(first, second));
+            EXPECT_EQ(reduced(first - second), barrett.submod(first, second));
+        }
+    }
+}
+
+TEST(correctness_random, gcd) {
+    std::default_random_engine rng(42);
+    size_t const sizes[][2] = {{30, 30}, {64, 60}, {200, 190}, {1000, 300}, {3000, 3000}, {12000, 11000}, {40000, 39000}};
+    for (auto const &size : sizes) {
+        big_integer_gmp a, b, c;
+        a.random(size[0], rng);
+        b.random(size[1], rng);
+        c.random(size[1] / 4, rng);
+        big_integer common = big_integer(to_string(c)) + 1;
+        big_integer first = big_integer(to_string(a)) * common, second = big_integer(to_string(b)) * common;
+        big_integer x, y;
+        big_integer divisor = gcdext(first, second, x, y);
+        // a common divisor that is a combination of both is the greatest one
+        EXPECT_EQ(divisor, gcd(first, second));
+        EXPECT_EQ(0, first % divisor);
+        EXPECT_EQ(0, second % divisor);
+        EXPECT_EQ(divisor, first * x + second * y);
+        if (size[0] <= 3000) {
+            EXPECT_EQ(naive_gcd(first, second), divisor);
+        }
+        big_integer modulus = abs(second / divisor), value = first / divisor;
+        EXPECT_EQ(0, (invert(value, modulus) * value - 1) % modulus);
+    }
+}
+
+TEST(correctness_random, pow) {
+    std::default_random_engine rng(42);
+    size_t const sizes[] = {3, 20, 31, 45, 200};
+    for (size_t size : sizes) {
+        big_integer_gmp a;
+        a.random(size, rng);
+        big_integer base = big_integer(to_string(a));
+        for (big_integer const &value : {base, base << 37, base * 10}) {
+            big_integer expected = 1;
+            for (uint64_t exponent = 0; exponent < 70; exponent++) {
+                EXPECT_EQ(expected, pow(value, exponent));
+                expected *= value;
+            }
+        }
+    }
+}
+
+TEST(correctness_random, combinatorics) {
+    std::default_random_engine rng(42);
+    big_integer expected = 1;
+    for (uint64_t n = 1; n <= 3000; n++) {
+        expected *= n;
+        if (n < 100 || rng() % 50 == 0) {
+            EXPECT_EQ(expected, factorial(n));
+        }
+    }
+
+    // Pascal's rule across both the prime and the ratio strategy
+    for (int itn = 0; itn < 100; itn++) {
+        uint64_t n = 2 + rng() % 5000;
+        uint64_t k = 1 + rng() % (itn % 2 ? n / 40 + 1 : n - 1);
+        EXPECT_EQ(binomial(n, k), binomial(n - 1, k - 1) + binomial(n - 1, k));
+        EXPECT_EQ(binomial(n, k), binomial(n, n - k));
+    }
+    EXPECT_EQ(factorial(4000) / (factorial(1000) * factorial(3000)), binomial(4000, 1000));
+
+    big_integer primes = 1;
+    for (uint64_t n = 2; n <= 2000; n++) {
+        bool prime = true;
+        for (uint64_t d = 2; d * d <= n; d++) {
+            prime = prime && n % d != 0;
+        }
+        if (prime) {
+            primes *= n;
+        }
+        if (n < 100 || rng() % 50 == 0) {
+            EXPECT_EQ(primes, primorial(n));
+        }
+    }
+}
+
+TEST(correctness_random, roots) {
+    std::default_random_engine rng(42);
+    size_t const sizes[] = {10, 70, 500, 3000, 20000, 60000};
+    for (size_t size : sizes) {
+        big_integer_gmp a;
+        a.random(size, rng);
+        big_integer value = abs(big_integer(to_string(a)));
+        big_integer root = isqrt(value);
+        EXPECT_TRUE(root * root <= value && (root + 1) * (root + 1) > value);
+        EXPECT_EQ(root, isqrt(root * root));
+        EXPECT_EQ(root - 1, isqrt(root * root - 1));
+        for (uint64_t k : {3, 5, 17, 1000}) {
+            root = iroot(value, k);
+            big_integer lower = 1, upper = 1;
+            for (uint64_t i = 0; i < k; i++) {
+                lower *= root;
+                upper *= root + 1;
+            }
+            EXPECT_TRUE(lower <= value && upper > value);
+            EXPECT_EQ(root, iroot(lower, k));
+        }
+    }
+}
+
+TEST(correctness_random, mul_toom_cook) {
+    std::default_random_engine rng(42);
+    size_t const sizes[][2] = {{1100, 1000}, {2200, 1700}, {2400, 2000}};
+    for (auto const &size : sizes) {
+        big_integer a = random_digits(size[0], rng);
+        big_integer b = random_digits(size[1], rng);
+        big_integer c = a * b;
+        EXPECT_EQ(b, c / a);
+        EXPECT_EQ(a, c / b);
+        EXPECT_EQ(0, c % a);
+    }
+}
+
+TEST(correctness_random, mul_ntt) {
+    std::default_random_engine rng(42);
+    size_t const sizes[][2] = {{4500, 3000}, {12000, 2300}};
+    int const prime = 1000000007;
+    for (auto const &size : sizes) {
+        big_integer a = random_digits(size[0], rng);
+        big_integer b = random_digits(size[1], rng);
+        big_integer c = a * b;
+        EXPECT_EQ(c % prime, (a % prime) * (b % prime) % prime);
+        EXPECT_EQ(b, c / a);
+        EXPECT_EQ(a, c / b);
+    }
+}
+
+TEST(correctness_random, sqr) {
+    std::default_random_engine rng(42);
+    size_t const sizes[] = {20, 60, 300, 1000, 1600, 3000};
+    for (size_t size : sizes) {
+        big_integer a = random_digits(size, rng);
+        big_integer square = a * (a + 1) - a;
+        EXPECT_EQ(square, a * a);
+        a = -a;
+        a *= a;
+        EXPECT_EQ(square, a);
+    }
+}
+
+TEST(correctness_random, div_long_operands) {
+    std::default_random_engine rng(322);
+    size_t const sizes[][2] = {{max_size * 8, max_size * 4}, {max_size * 8, max_size * 7}, {max_size * 10, max_size}};
+    for (auto const &size : sizes) {
+        big_integer_gmp a, b;
+        a.random(size[0], rng);
+        b.random(size[1], rng);
+        big_integer A = big_integer(to_string(a)), B = big_integer(to_string(b));
+        EXPECT_EQ(to_string(a / b), to_string(A / B));
+        EXPECT_EQ(to_string(a % b), to_string(A % B));
+    }
+}
+
+TEST(correctness_random, div_burnikel_ziegler) {
+    std::default_random_engine rng(322);
+    size_t const sizes[][2] = {{3000, 1500}, {5000, 300}, {2000, 1900}, {4500, 2100}};
+    for (auto const &size : sizes) {
+        big_integer b = random_digits(size[1], rng);
+        big_integer q = random_digits(size[0] - size[1], rng);
+        big_integer r = random_digits(size[1], rng) % b;
+        big_integer a = q * b + r;
+        EXPECT_EQ(q, a / b);
+        EXPECT_EQ(r, a % b);
+    }
+}
+
+TEST(correctness_random, div_newton) {
+    std::default_random_engine rng(322);
+    size_t const sizes[][2] = {{45000, 22000}, {70000, 22000}};
+    for (auto const &size : sizes) {
+        big_integer b = random_digits(size[1], rng);
+        big_integer q = random_digits(size[0] - size[1], rng);
+        big_integer r = random_digits(size[1] - 1, rng);
+        big_integer a = q * b + r;
+        EXPECT_EQ(q, a / b);
+        EXPECT_EQ(r, a % b);
+    }
+}
+
+TEST(correctness, div_long_all_ones) {
+    for (int limbs : {3, 100, 700}) {
+        big_integer b = (big_integer(1) << (32 * limbs)) - 1;
+        big_integer a = (big_integer(1) << (96 * limbs)) - 1;
+        big_integer q = (big_integer(1) << (64 * limbs)) + (big_integer(1) << (32 * limbs)) + 1;
+        EXPECT_EQ(q, a / b);
+        EXPECT_EQ(0, a % b);
+        EXPECT_EQ(q - 1, (a - 1) / b);
+        EXPECT_EQ(b - 1, (a - 1) % b);
+    }
+}
+
 TEST(correctness_random, div) {
     std::default_random_engine rng(322);
     for (size_t itn = 0; itn != number_of_iterations; ++itn) {
@@ -796,6 +1638,24 @@ TEST(correctness_random, bitwise) {
     }
 }
 
+TEST(correctness_random, bitwise_long_operands) {
+    std::default_random_engine rng(322);
+    size_t const sizes[][2] = {{max_size * 8, max_size * 3}, {max_size * 3, max_size * 8}, {max_size * 5, max_size * 5}};
+    for (auto const &size : sizes) {
+        for (size_t itn = 0; itn != 4; ++itn) {
+            big_integer_gmp a, b;
+            a.random(size[0], rng);
+            b.random(size[1], rng);
+            big_integer A = big_integer(to_string(a)), B = big_integer(to_string(b));
+            EXPECT_EQ(to_string(a & b), to_string(A & B));
+            EXPECT_EQ(to_string(a | b), to_string(A | B));
+            EXPECT_EQ(to_string(a ^ b), to_string(A ^ B));
+            A ^= B;
+            EXPECT_EQ(to_string(a ^ b), to_string(A));
+        }
+    }
+}
+
 TEST(correctness_random, bit_shifts) {
     std::default_random_engine rng(42);
     for (size_t itn = 0; itn != number_of_iterations; ++itn) {
@@ -809,7 +1669,25 @@ TEST(correctness_random, bit_shifts) {
     }
 }
 
-// TODO: extend due to idea
+TEST(correctness_random, bit_shifts_long) {
+    std::default_random_engine rng(1234);
+    for (size_t itn = 0; itn != 64; ++itn) {
+        big_integer_gmp a;
+        a.random(max_size * 20, rng);
+        int shift = static_cast<int>(rng() % (max_size * 25));
+        if (itn % 4 == 0) {
+            shift -= shift % 32;
+        }
+        big_integer R = big_integer(to_string(a));
+
+        EXPECT_EQ(to_string(a << shift), to_string(R << shift));
+        EXPECT_EQ(to_string(a >> shift), to_string(R >> shift));
+        R >>= shift;
+        EXPECT_EQ(to_string(a >> shift), to_string(R));
+    }
+}
+
+
 TEST(correctness_twos_complement, simple) {
     std::string a = "-36893488147419103232"; // -(1 << 65)
     std::string b = "147573952589676412928"; //  (1 << 67)